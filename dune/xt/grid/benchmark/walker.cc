@@ -0,0 +1,270 @@
+// This file is part of the dune-xt-grid project:
+//   https://github.com/dune-community/dune-xt-grid
+// Copyright 2009-2018 dune-xt-grid developers and contributors. All rights reserved.
+// License: Dual licensed as BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+//      or  GPL-2.0+ (http://opensource.org/licenses/gpl-license)
+//          with "runtime exception" (http://www.dune-project.org/license.html)
+
+/**
+ * \file
+ * \brief Measures the throughput (elements and intersections per second) of Walker::walk.
+ *
+ * Walks the leaf views of cube grids (YaspGrid and, if available, ALUGrid and UGGrid) with 1 to max_functors appended
+ * lambdas or functors, serially and with TBB for all given thread counts and partition factors. Each configuration is
+ * walked repetitions times and the fastest walk is reported, one record per configuration, as CSV or JSON.
+ *
+ * Options (given as -key value):
+ *   format            csv or json (default: csv)
+ *   output            file to write the records to (default: standard output)
+ *   num_elements_2d   elements per direction of the 2d grids (default: 256)
+ *   num_elements_3d   elements per direction of the 3d grids (default: 32)
+ *   max_functors      (default: 4)
+ *   repetitions       (default: 5)
+ *   threads           space separated list of thread counts (default: 1 2 4)
+ *   partition_factors space separated list of partition factors (default: 1 8 32)
+ */
+
+#include <config.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/parametertreeparser.hh>
+
+#include <dune/xt/common/configuration.hh>
+#include <dune/xt/common/exceptions.hh>
+#include <dune/xt/common/parallel/threadmanager.hh>
+
+#include <dune/xt/grid/gridprovider/cube.hh>
+#include <dune/xt/grid/grids.hh>
+#include <dune/xt/grid/information.hh>
+#include <dune/xt/grid/walker.hh>
+
+using namespace Dune;
+using namespace Dune::XT::Grid;
+
+
+struct Record
+{
+  std::string grid;
+  size_t dimension;
+  size_t elements;
+  size_t intersections;
+  std::string kind;
+  size_t functors;
+  bool tbb;
+  size_t threads;
+  size_t partition_factor;
+  double seconds;
+};
+
+
+//! counts elements and intersections, thread local copies are merged on join
+template <class GridLayerType>
+struct CountingFunctor : public Functor::Codim0And1<GridLayerType>
+{
+  typedef Functor::Codim0And1<GridLayerType> BaseType;
+  using typename BaseType::EntityType;
+  using typename BaseType::IntersectionType;
+
+  void apply_local(const EntityType&) override final
+  {
+    ++elements;
+  }
+
+  void apply_local(const IntersectionType&, const EntityType&, const EntityType&) override final
+  {
+    ++intersections;
+  }
+
+  BaseType* copy() override final
+  {
+    return new CountingFunctor();
+  }
+
+  void join(BaseType& other) override final
+  {
+    auto& other_counter = dynamic_cast<CountingFunctor&>(other);
+    elements += other_counter.elements;
+    intersections += other_counter.intersections;
+  }
+
+  size_t elements = 0;
+  size_t intersections = 0;
+};
+
+
+template <class GridLayerType>
+double time_walk(const GridLayerType& grid_layer,
+                 const Statistics& statistics,
+                 const std::string& kind,
+                 const size_t num_functors,
+                 const bool use_tbb,
+                 const size_t repetitions)
+{
+  using EntityType = extract_entity_t<GridLayerType>;
+  using IntersectionType = extract_intersection_t<GridLayerType>;
+  const auto& index_set = grid_layer.indexSet();
+  // the lambdas are not copied for each thread, each element (and thus each inside element) is visited by one thread
+  std::vector<double> element_data(index_set.size(0), 0.);
+  double seconds = std::numeric_limits<double>::max();
+  for (size_t rr = 0; rr < repetitions; ++rr) {
+    Walker<GridLayerType> walker(grid_layer);
+    std::vector<std::unique_ptr<CountingFunctor<GridLayerType>>> functors;
+    for (size_t ff = 0; ff < num_functors; ++ff) {
+      if (kind == "lambda") {
+        walker.append([&](const EntityType& element) { element_data[index_set.index(element)] += 1.; });
+        walker.append([&](const IntersectionType&, const EntityType& inside, const EntityType&) {
+          element_data[index_set.index(inside)] += 1.;
+        });
+      } else {
+        functors.emplace_back(new CountingFunctor<GridLayerType>());
+        walker.append(*functors.back());
+      }
+    }
+    const auto start = std::chrono::steady_clock::now();
+    walker.walk(use_tbb);
+    seconds = std::min(seconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    for (const auto& functor : functors)
+      if (functor->elements != statistics.numberOfEntities
+          || functor->intersections != statistics.numberOfIntersections)
+        DUNE_THROW(XT::Common::Exceptions::internal_error,
+                   "The walk visited " << functor->elements << " elements and " << functor->intersections
+                                       << " intersections, should have visited "
+                                       << statistics.numberOfEntities
+                                       << " elements and "
+                                       << statistics.numberOfIntersections
+                                       << " intersections!");
+  }
+  return seconds;
+} // ... time_walk(...)
+
+
+template <class GridType>
+void benchmark(const std::string& grid_name, const ParameterTree& options, std::vector<Record>& records)
+{
+  static const constexpr size_t dimension = GridType::dimension;
+  const auto num_elements = options.get<unsigned int>("num_elements_" + std::to_string(dimension) + "d",
+                                                      dimension == 2 ? 256u : 32u);
+  const auto max_functors = options.get<size_t>("max_functors", 4);
+  const auto repetitions = options.get<size_t>("repetitions", 5);
+  const auto threads = options.get<std::vector<size_t>>("threads", {1, 2, 4});
+  const auto partition_factors = options.get<std::vector<size_t>>("partition_factors", {1, 8, 32});
+  const auto grid_provider = make_cube_grid<GridType>(0., 1., num_elements);
+  const auto grid_layer = grid_provider.grid().leafGridView();
+  const Statistics statistics(grid_layer);
+  for (const std::string kind : {"lambda", "functor"}) {
+    for (size_t num_functors = 1; num_functors <= max_functors; ++num_functors) {
+      Record record{grid_name,
+                    dimension,
+                    statistics.numberOfEntities,
+                    statistics.numberOfIntersections,
+                    kind,
+                    num_functors,
+                    false,
+                    1,
+                    0,
+                    0.};
+      record.seconds = time_walk(grid_layer, statistics, kind, num_functors, false, repetitions);
+      records.push_back(record);
+#if HAVE_TBB
+      record.tbb = true;
+      for (const auto num_threads : threads) {
+        XT::Common::threadManager().set_max_threads(num_threads);
+        record.threads = num_threads;
+        for (const auto partition_factor : partition_factors) {
+          DXTC_CONFIG.set("threading.partition_factor", partition_factor, /*overwrite=*/true);
+          record.partition_factor = partition_factor;
+          record.seconds = time_walk(grid_layer, statistics, kind, num_functors, true, repetitions);
+          records.push_back(record);
+        }
+      }
+#else
+      DUNE_UNUSED_PARAMETER(threads);
+      DUNE_UNUSED_PARAMETER(partition_factors);
+#endif
+    }
+  }
+} // ... benchmark(...)
+
+
+void write_csv(const std::vector<Record>& records, std::ostream& out)
+{
+  out << "grid,dimension,elements,intersections,kind,functors,tbb,threads,partition_factor,seconds,"
+      << "elements_per_second,intersections_per_second\n";
+  for (const auto& record : records)
+    out << record.grid << "," << record.dimension << "," << record.elements << "," << record.intersections << ","
+        << record.kind << "," << record.functors << "," << record.tbb << "," << record.threads << ","
+        << record.partition_factor << "," << record.seconds << "," << record.elements / record.seconds << ","
+        << record.intersections / record.seconds << "\n";
+}
+
+
+void write_json(const std::vector<Record>& records, std::ostream& out)
+{
+  out << "[";
+  for (size_t ii = 0; ii < records.size(); ++ii) {
+    const auto& record = records[ii];
+    out << (ii == 0 ? "\n" : ",\n") << "  {\"grid\": \"" << record.grid << "\", \"dimension\": " << record.dimension
+        << ", \"elements\": " << record.elements << ", \"intersections\": " << record.intersections
+        << ", \"kind\": \"" << record.kind << "\", \"functors\": " << record.functors
+        << ", \"tbb\": " << (record.tbb ? "true" : "false") << ", \"threads\": " << record.threads
+        << ", \"partition_factor\": " << record.partition_factor << ", \"seconds\": " << record.seconds
+        << ", \"elements_per_second\": " << record.elements / record.seconds
+        << ", \"intersections_per_second\": " << record.intersections / record.seconds << "}";
+  }
+  out << "\n]\n";
+}
+
+
+int main(int argc, char** argv)
+{
+  try {
+    MPIHelper::instance(argc, argv);
+    ParameterTree options;
+    ParameterTreeParser::readOptions(argc, argv, options);
+    const auto format = options.get<std::string>("format", "csv");
+    if (format != "csv" && format != "json")
+      DUNE_THROW(XT::Common::Exceptions::wrong_input_given, "format has to be csv or json, is " << format << "!");
+
+    std::vector<Record> records;
+    benchmark<YASP_2D_EQUIDISTANT_OFFSET>("yasp", options, records);
+    benchmark<YASP_3D_EQUIDISTANT_OFFSET>("yasp", options, records);
+#if HAVE_DUNE_ALUGRID
+    benchmark<ALU_2D_SIMPLEX_CONFORMING>("alu_simplex_conforming", options, records);
+    benchmark<ALU_3D_CUBE>("alu_cube", options, records);
+#endif
+#if HAVE_DUNE_UGGRID || HAVE_UG
+    benchmark<UG_2D>("ug", options, records);
+    benchmark<UG_3D>("ug", options, records);
+#endif
+
+    if (MPIHelper::getCollectiveCommunication().rank() != 0)
+      return EXIT_SUCCESS;
+    std::ofstream file;
+    if (options.hasKey("output"))
+      file.open(options["output"]);
+    std::ostream& out = options.hasKey("output") ? file : std::cout;
+    if (format == "json")
+      write_json(records, out);
+    else
+      write_csv(records, out);
+  } catch (Dune::Exception& e) {
+    std::cerr << "Dune reported: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  } catch (std::exception& e) {
+    std::cerr << "stl reported: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+} // ... main(...)
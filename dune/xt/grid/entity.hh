@@ -24,6 +24,7 @@
 #include <dune/xt/common/ranges.hh>
 #include <dune/xt/common/string.hh>
 #include <dune/xt/common/type_traits.hh>
+#include <dune/xt/grid/type_traits.hh>
 
 namespace Dune {
 namespace XT {
@@ -62,6 +63,41 @@ double entity_diameter(const Dune::Entity<codim, worlddim, GridImp, EntityImp>&
 } // entity_diameter
 
 
+namespace internal {
+
+
+template <class GridLayerType, bool part = is_part<GridLayerType>::value>
+struct EntityFromSeed
+{
+  template <class SeedType>
+  static extract_entity_t<GridLayerType> get(const GridLayerType& grid_layer, const SeedType& seed)
+  {
+    return grid_layer.grid().entity(seed);
+  }
+};
+
+template <class GridLayerType>
+struct EntityFromSeed<GridLayerType, true>
+{
+  template <class SeedType>
+  static extract_entity_t<GridLayerType> get(const GridLayerType& grid_layer, const SeedType& seed)
+  {
+    return grid_layer.entity(seed);
+  }
+};
+
+
+} // namespace internal
+
+
+//! The element of the grid layer with the given seed, obtained from the grid for grid views and from grid parts.
+template <class GridLayerType, class SeedType>
+extract_entity_t<GridLayerType> entity_from_seed(const GridLayerType& grid_layer, const SeedType& seed)
+{
+  return internal::EntityFromSeed<GridLayerType>::get(grid_layer, seed);
+}
+
+
 template <int codim, int worlddim, class GridImp, template <int, int, class> class EntityImp>
 auto reference_element(const Dune::Entity<codim, worlddim, GridImp, EntityImp>& entity)
     -> decltype(ReferenceElements<typename GridImp::ctype, worlddim>::general(entity.type()))
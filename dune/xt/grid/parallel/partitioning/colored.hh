@@ -0,0 +1,187 @@
+// This file is part of the dune-xt-grid project:
+//   https://github.com/dune-community/dune-xt-grid
+// Copyright 2009-2018 dune-xt-grid developers and contributors. All rights reserved.
+// License: Dual licensed as BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+//      or  GPL-2.0+ (http://opensource.org/licenses/gpl-license)
+//          with "runtime exception" (http://www.dune-project.org/license.html)
+
+#ifndef DUNE_XT_GRID_PARALLEL_PARTITIONING_COLORED_HH
+#define DUNE_XT_GRID_PARALLEL_PARTITIONING_COLORED_HH
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <dune/grid/common/rangegenerators.hh>
+
+#include <dune/xt/grid/parallel/partitioning/weighted.hh>
+
+namespace Dune {
+namespace XT {
+namespace Grid {
+namespace internal {
+
+
+//! The elements of one color of a ColoredPartitioning.
+template <class GridLayerImp>
+class ColorClassPartitioning : public WeightedPartitioning<GridLayerImp>
+{
+  typedef WeightedPartitioning<GridLayerImp> BaseType;
+
+public:
+  using typename BaseType::GridLayerType;
+  using typename BaseType::EntitySeedType;
+  using typename BaseType::Size;
+
+  ColorClassPartitioning(const GridLayerType& grid_layer,
+                         const Size num_partitions,
+                         std::vector<EntitySeedType>&& seeds,
+                         std::vector<size_t>&& indices)
+    : BaseType(grid_layer, num_partitions, nullptr)
+  {
+    this->seeds_ = std::move(seeds);
+    this->indices_ = std::move(indices);
+    this->costs_.assign(this->seeds_.size(), 1.);
+    this->chunk();
+  }
+}; // class ColorClassPartitioning
+
+
+} // namespace internal
+
+
+/**
+ * \brief Greedy coloring of the elements of a grid layer, such that elements of the same color are independent.
+ *
+ * Two elements get different colors if they share a vertex. If conflicts_via_neighbors is true (the default), two
+ * elements also get different colors if one of them shares a vertex with a face neighbor of the other (or if they
+ * have a common face neighbor), so that codim 1 functors may also write to data associated with the outside element.
+ * The elements of each color are partitioned into chunks like in WeightedPartitioning.
+ *
+ * \note Requires the index set of the grid layer to provide indices for vertices.
+ * \sa   Walker::walk_colored
+ */
+template <class GridLayerImp>
+class ColoredPartitioning
+{
+  static_assert(is_layer<GridLayerImp>::value, "");
+
+public:
+  typedef GridLayerImp GridLayerType;
+  using EntityType = extract_entity_t<GridLayerType>;
+  typedef internal::ColorClassPartitioning<GridLayerType> ColorType;
+  typedef typename ColorType::EntitySeedType EntitySeedType;
+  static const constexpr size_t dimDomain = GridLayerType::dimension;
+
+  ColoredPartitioning(const GridLayerType& grid_layer,
+                      const size_t num_partitions_per_color,
+                      const bool conflicts_via_neighbors = true)
+  {
+    const auto& index_set = grid_layer.indexSet();
+    const size_t num_elements = grid_layer.size(0);
+    // collect the seeds, vertices and face neighbors of all elements
+    std::vector<EntitySeedType> seeds;
+    std::vector<size_t> indices;
+    std::vector<size_t> vertex_offsets(1, 0);
+    std::vector<size_t> vertices;
+    std::vector<size_t> neighbor_offsets(1, 0);
+    std::vector<size_t> neighbors;
+    seeds.reserve(num_elements);
+    indices.reserve(num_elements);
+    vertex_offsets.reserve(num_elements + 1);
+    neighbor_offsets.reserve(num_elements + 1);
+    std::vector<size_t> position_of_index(index_set.size(0), std::numeric_limits<size_t>::max());
+    for (auto&& element : elements(grid_layer)) {
+      position_of_index[index_set.index(element)] = seeds.size();
+      seeds.emplace_back(element.seed());
+      indices.push_back(index_set.index(element));
+      for (size_t ii = 0; ii < element.subEntities(dimDomain); ++ii)
+        vertices.push_back(index_set.subIndex(element, ii, dimDomain));
+      vertex_offsets.push_back(vertices.size());
+      if (conflicts_via_neighbors) {
+        const auto intersection_it_end = grid_layer.iend(element);
+        for (auto intersection_it = grid_layer.ibegin(element); intersection_it != intersection_it_end;
+             ++intersection_it) {
+          const auto& intersection = *intersection_it;
+          if (intersection.neighbor())
+            neighbors.push_back(index_set.index(intersection.outside()));
+        }
+      }
+      neighbor_offsets.push_back(neighbors.size());
+    }
+    // the vertices touched by each element: its own and those of its neighbors
+    std::vector<size_t> touched_offsets(1, 0);
+    std::vector<size_t> touched;
+    touched_offsets.reserve(seeds.size() + 1);
+    for (size_t ee = 0; ee < seeds.size(); ++ee) {
+      const size_t first = touched.size();
+      touched.insert(touched.end(), vertices.begin() + vertex_offsets[ee], vertices.begin() + vertex_offsets[ee + 1]);
+      for (size_t nn = neighbor_offsets[ee]; nn < neighbor_offsets[ee + 1]; ++nn) {
+        const size_t neighbor = position_of_index[neighbors[nn]];
+        if (neighbor < seeds.size())
+          touched.insert(touched.end(),
+                         vertices.begin() + vertex_offsets[neighbor],
+                         vertices.begin() + vertex_offsets[neighbor + 1]);
+      }
+      std::sort(touched.begin() + first, touched.end());
+      touched.erase(std::unique(touched.begin() + first, touched.end()), touched.end());
+      touched_offsets.push_back(touched.size());
+    }
+    // greedy coloring: an element may not have the color of an element which touches one of its vertices
+    const size_t num_vertices = index_set.size(dimDomain);
+    std::vector<std::vector<size_t>> colored_elements_of_vertex(num_vertices);
+    std::vector<size_t> colors(seeds.size());
+    std::vector<size_t> forbidden_by;
+    size_t num_colors = 0;
+    for (size_t ee = 0; ee < seeds.size(); ++ee) {
+      for (size_t vv = touched_offsets[ee]; vv < touched_offsets[ee + 1]; ++vv)
+        for (const auto& other : colored_elements_of_vertex[touched[vv]])
+          forbidden_by[colors[other]] = ee;
+      size_t color = 0;
+      while (color < num_colors && forbidden_by[color] == ee)
+        ++color;
+      if (color == num_colors) {
+        ++num_colors;
+        forbidden_by.push_back(std::numeric_limits<size_t>::max());
+      }
+      colors[ee] = color;
+      for (size_t vv = touched_offsets[ee]; vv < touched_offsets[ee + 1]; ++vv)
+        colored_elements_of_vertex[touched[vv]].push_back(ee);
+    }
+    // sort by color, preserving the order of the grid layer within each color
+    std::vector<std::vector<EntitySeedType>> seeds_of_color(num_colors);
+    std::vector<std::vector<size_t>> indices_of_color(num_colors);
+    for (size_t ee = 0; ee < seeds.size(); ++ee) {
+      seeds_of_color[colors[ee]].emplace_back(seeds[ee]);
+      indices_of_color[colors[ee]].push_back(indices[ee]);
+    }
+    for (size_t cc = 0; cc < num_colors; ++cc)
+      colors_.emplace_back(new ColorType(
+          grid_layer, num_partitions_per_color, std::move(seeds_of_color[cc]), std::move(indices_of_color[cc])));
+  } // ColoredPartitioning(...)
+
+  size_t colors() const
+  {
+    return colors_.size();
+  }
+
+  //! The elements of the given color, \sa WeightedPartitioning
+  const ColorType& color(const size_t cc) const
+  {
+    return *colors_[cc];
+  }
+
+private:
+  std::vector<std::unique_ptr<ColorType>> colors_;
+}; // class ColoredPartitioning
+
+template <class GL>
+const constexpr size_t ColoredPartitioning<GL>::dimDomain;
+
+
+} // namespace Grid
+} // namespace XT
+} // namespace Dune
+
+#endif // DUNE_XT_GRID_PARALLEL_PARTITIONING_COLORED_HH
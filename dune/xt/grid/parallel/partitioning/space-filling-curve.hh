@@ -0,0 +1,196 @@
+// This file is part of the dune-xt-grid project:
+//   https://github.com/dune-community/dune-xt-grid
+// Copyright 2009-2018 dune-xt-grid developers and contributors. All rights reserved.
+// License: Dual licensed as BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+//      or  GPL-2.0+ (http://opensource.org/licenses/gpl-license)
+//          with "runtime exception" (http://www.dune-project.org/license.html)
+
+#ifndef DUNE_XT_GRID_PARALLEL_PARTITIONING_SPACE_FILLING_CURVE_HH
+#define DUNE_XT_GRID_PARALLEL_PARTITIONING_SPACE_FILLING_CURVE_HH
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+
+#include <dune/grid/common/rangegenerators.hh>
+
+#include <dune/xt/grid/parallel/partitioning/weighted.hh>
+
+namespace Dune {
+namespace XT {
+namespace Grid {
+
+
+enum class SpaceFillingCurve
+{
+  hilbert,
+  morton
+};
+
+
+namespace internal {
+
+
+/**
+ * \brief Position of a point with integer coordinates (of the given number of bits each) along a space filling curve.
+ *
+ * The Hilbert curve is computed by the algorithm from J. Skilling, "Programming the Hilbert curve", AIP Conference
+ * Proceedings 707 (2004), the Morton (Z-order) curve by interleaving the bits of the coordinates.
+ */
+template <size_t d>
+uint64_t space_filling_curve_key(std::array<uint32_t, d> x, const size_t bits, const SpaceFillingCurve curve)
+{
+  static_assert(d > 0, "");
+  if (curve == SpaceFillingCurve::hilbert && bits > 1) {
+    const uint32_t m = uint32_t(1) << (bits - 1);
+    // inverse undo excess work
+    for (uint32_t q = m; q > 1; q >>= 1) {
+      const uint32_t p = q - 1;
+      for (size_t ii = 0; ii < d; ++ii) {
+        if (x[ii] & q)
+          x[0] ^= p;
+        else {
+          const uint32_t t = (x[0] ^ x[ii]) & p;
+          x[0] ^= t;
+          x[ii] ^= t;
+        }
+      }
+    }
+    // gray encode
+    for (size_t ii = 1; ii < d; ++ii)
+      x[ii] ^= x[ii - 1];
+    uint32_t t = 0;
+    for (uint32_t q = m; q > 1; q >>= 1)
+      if (x[d - 1] & q)
+        t ^= q - 1;
+    for (size_t ii = 0; ii < d; ++ii)
+      x[ii] ^= t;
+  }
+  // interleave, most significant bits first
+  uint64_t key = 0;
+  for (size_t bb = bits; bb > 0; --bb)
+    for (size_t ii = 0; ii < d; ++ii)
+      key = (key << 1) | ((x[ii] >> (bb - 1)) & 1);
+  return key;
+} // ... space_filling_curve_key(...)
+
+
+} // namespace internal
+
+
+/**
+ * \brief WeightedPartitioning of the elements ordered along a space filling curve through their centers.
+ *
+ * The partitions are contiguous segments of the curve, so neighboring elements are usually processed by the same
+ * thread. everything() iterates over all elements in the order of the curve, which may also be used for serial walks
+ * (\sa Walker::walk) on grids with a poor native iteration order.
+ */
+template <class GridLayerImp>
+class SpaceFillingCurvePartitioning : public WeightedPartitioning<GridLayerImp>
+{
+  typedef WeightedPartitioning<GridLayerImp> BaseType;
+
+public:
+  using typename BaseType::GridLayerType;
+  using typename BaseType::EntityType;
+  using typename BaseType::Size;
+  static const constexpr size_t dimWorld = EntityType::Geometry::coorddimension;
+  typedef FieldVector<typename EntityType::Geometry::ctype, dimWorld> DomainType;
+
+  SpaceFillingCurvePartitioning(const GridLayerType& grid_layer,
+                                const Size num_partitions,
+                                const SpaceFillingCurve curve = SpaceFillingCurve::hilbert)
+    : SpaceFillingCurvePartitioning(grid_layer, num_partitions, [](const EntityType&) { return 1.; }, curve)
+  {
+  }
+
+  SpaceFillingCurvePartitioning(const GridLayerType& grid_layer,
+                                const Size num_partitions,
+                                const std::function<double(const EntityType&)>& cost,
+                                const SpaceFillingCurve curve = SpaceFillingCurve::hilbert)
+    : BaseType(grid_layer, num_partitions, nullptr)
+  {
+    collect([&](const EntityType& element, const size_t /*index*/) { return cost(element); }, curve);
+  }
+
+  //! \sa WeightedPartitioning
+  SpaceFillingCurvePartitioning(const GridLayerType& grid_layer,
+                                const Size num_partitions,
+                                const std::vector<double>& costs,
+                                const SpaceFillingCurve curve = SpaceFillingCurve::hilbert)
+    : BaseType(grid_layer, num_partitions, nullptr)
+  {
+    this->check_size(costs);
+    collect([&](const EntityType& /*element*/, const size_t index) { return costs[index]; }, curve);
+  }
+
+private:
+  template <class CostFunctionType>
+  void collect(const CostFunctionType& cost, const SpaceFillingCurve curve)
+  {
+    const auto& index_set = this->grid_layer_.indexSet();
+    const size_t num_elements = this->grid_layer_.size(0);
+    std::vector<typename BaseType::EntitySeedType> seeds;
+    std::vector<size_t> indices;
+    std::vector<double> costs;
+    std::vector<DomainType> centers;
+    seeds.reserve(num_elements);
+    indices.reserve(num_elements);
+    costs.reserve(num_elements);
+    centers.reserve(num_elements);
+    DomainType lower_left(std::numeric_limits<typename DomainType::value_type>::max());
+    DomainType upper_right(std::numeric_limits<typename DomainType::value_type>::lowest());
+    for (auto&& element : elements(this->grid_layer_)) {
+      const size_t index = index_set.index(element);
+      seeds.emplace_back(element.seed());
+      indices.push_back(index);
+      costs.push_back(cost(element, index));
+      centers.emplace_back(element.geometry().center());
+      for (size_t ii = 0; ii < dimWorld; ++ii) {
+        lower_left[ii] = std::min(lower_left[ii], centers.back()[ii]);
+        upper_right[ii] = std::max(upper_right[ii], centers.back()[ii]);
+      }
+    }
+    // map the bounding box of the centers to [0, 2^bits - 1]^d
+    const size_t bits = std::min(size_t(32), 64 / dimWorld);
+    const double max_coordinate = double((uint64_t(1) << bits) - 1);
+    std::vector<uint64_t> keys(seeds.size());
+    for (size_t ee = 0; ee < seeds.size(); ++ee) {
+      std::array<uint32_t, dimWorld> coordinates;
+      for (size_t ii = 0; ii < dimWorld; ++ii) {
+        const auto extent = upper_right[ii] - lower_left[ii];
+        coordinates[ii] =
+            extent > 0 ? uint32_t(((centers[ee][ii] - lower_left[ii]) / extent) * max_coordinate) : uint32_t(0);
+      }
+      keys[ee] = internal::space_filling_curve_key(coordinates, bits, curve);
+    }
+    std::vector<size_t> order(seeds.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](const size_t& a, const size_t& b) { return keys[a] < keys[b]; });
+    this->seeds_.reserve(seeds.size());
+    this->indices_.reserve(seeds.size());
+    this->costs_.reserve(seeds.size());
+    for (const auto& ee : order) {
+      this->seeds_.emplace_back(seeds[ee]);
+      this->indices_.push_back(indices[ee]);
+      this->costs_.push_back(costs[ee]);
+    }
+    this->chunk();
+  } // ... collect(...)
+}; // class SpaceFillingCurvePartitioning
+
+template <class GL>
+const constexpr size_t SpaceFillingCurvePartitioning<GL>::dimWorld;
+
+
+} // namespace Grid
+} // namespace XT
+} // namespace Dune
+
+#endif // DUNE_XT_GRID_PARALLEL_PARTITIONING_SPACE_FILLING_CURVE_HH
@@ -0,0 +1,310 @@
+// This file is part of the dune-xt-grid project:
+//   https://github.com/dune-community/dune-xt-grid
+// Copyright 2009-2018 dune-xt-grid developers and contributors. All rights reserved.
+// License: Dual licensed as BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+//      or  GPL-2.0+ (http://opensource.org/licenses/gpl-license)
+//          with "runtime exception" (http://www.dune-project.org/license.html)
+
+#ifndef DUNE_XT_GRID_PARALLEL_PARTITIONING_WEIGHTED_HH
+#define DUNE_XT_GRID_PARALLEL_PARTITIONING_WEIGHTED_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+#if HAVE_TBB
+#include <tbb/tbb_stddef.h>
+#endif
+
+#include <dune/grid/common/rangegenerators.hh>
+
+#include <dune/xt/common/exceptions.hh>
+#include <dune/xt/grid/entity.hh>
+#include <dune/xt/grid/type_traits.hh>
+
+namespace Dune {
+namespace XT {
+namespace Grid {
+
+
+/**
+ * \brief Partitioning of the elements of a grid layer into chunks of (roughly) equal cost.
+ *
+ * In contrast to RangedPartitioning, the grid layer is only traversed once to collect the seeds of all elements (no
+ * std::distance or std::advance), and the chunks are chosen such that the sum of the costs of their elements is
+ * balanced. The costs may be given per element or as a vector indexed by the index set of the grid layer (e.g.
+ * measured in a previous walk), and can be changed by update_costs() without traversing the grid layer again.
+ *
+ * Use many more partitions than threads, the Walker then distributes them among the threads by work stealing.
+ * Provides the same interface as RangedPartitioning, \sa Walker::walk.
+ */
+template <class GridLayerImp>
+class WeightedPartitioning
+{
+  static_assert(is_layer<GridLayerImp>::value, "");
+
+public:
+  typedef GridLayerImp GridLayerType;
+  using EntityType = extract_entity_t<GridLayerType>;
+  typedef typename EntityType::EntitySeed EntitySeedType;
+  typedef size_t Size;
+  class Partition;
+
+  //! Each element has the same cost.
+  WeightedPartitioning(const GridLayerType& grid_layer, const Size num_partitions)
+    : WeightedPartitioning(grid_layer, num_partitions, [](const EntityType&) { return 1.; })
+  {
+  }
+
+  //! The cost of each element is computed once.
+  WeightedPartitioning(const GridLayerType& grid_layer,
+                       const Size num_partitions,
+                       const std::function<double(const EntityType&)>& cost)
+    : grid_layer_(grid_layer)
+    , num_partitions_(num_partitions)
+  {
+    collect([&](const EntityType& element, const size_t /*index*/) { return cost(element); });
+  }
+
+  //! The cost of each element is given by costs[index], with index from the index set of the grid layer.
+  WeightedPartitioning(const GridLayerType& grid_layer, const Size num_partitions, const std::vector<double>& costs)
+    : grid_layer_(grid_layer)
+    , num_partitions_(num_partitions)
+  {
+    check_size(costs);
+    collect([&](const EntityType& /*element*/, const size_t index) { return costs[index]; });
+  }
+
+  /**
+   * \brief Rebalances the partitions with new costs, indexed by the index set of the grid layer.
+   * \note  Only valid as long as the grid layer did not change.
+   */
+  void update_costs(const std::vector<double>& costs)
+  {
+    check_size(costs);
+    for (size_t ii = 0; ii < indices_.size(); ++ii)
+      costs_[ii] = costs[indices_[ii]];
+    chunk();
+  }
+
+  //! return maximum number of partitions
+  Size partitions() const
+  {
+    return entry_points_.size() - 1;
+  }
+
+  //! whole partitioning as a partition object
+  Partition everything() const
+  {
+    return Partition(*this, 0, partitions());
+  }
+
+  //! return a particular partition
+  Partition partition(Size pId) const
+  {
+    return Partition(*this, pId, pId + 1);
+  }
+
+  //! return a range of partitions
+  Partition partitions(Size first, Size last) const
+  {
+    return Partition(*this, first, last);
+  }
+
+  //! sum of the costs of the elements of a range of partitions
+  double cost(Size first, Size last) const
+  {
+    return cumulative_costs_[entry_points_[last]] - cumulative_costs_[entry_points_[first]];
+  }
+
+protected:
+  //! Only for derived classes which fill seeds_, indices_ and costs_ and then call chunk().
+  WeightedPartitioning(const GridLayerType& grid_layer, const Size num_partitions, std::nullptr_t)
+    : grid_layer_(grid_layer)
+    , num_partitions_(num_partitions)
+  {
+  }
+
+  template <class CostFunctionType>
+  void collect(const CostFunctionType& cost)
+  {
+    const auto& index_set = grid_layer_.indexSet();
+    const size_t num_elements = grid_layer_.size(0);
+    seeds_.reserve(num_elements);
+    indices_.reserve(num_elements);
+    costs_.reserve(num_elements);
+    for (auto&& element : elements(grid_layer_)) {
+      const size_t index = index_set.index(element);
+      seeds_.emplace_back(element.seed());
+      indices_.push_back(index);
+      costs_.push_back(cost(element, index));
+    }
+    chunk();
+  } // ... collect(...)
+
+  void check_size(const std::vector<double>& costs) const
+  {
+    if (costs.size() < size_t(grid_layer_.indexSet().size(0)))
+      DUNE_THROW(Common::Exceptions::shapes_do_not_match,
+                 "costs.size() = " << costs.size() << "\n   indexSet().size(0) = "
+                                   << grid_layer_.indexSet().size(0));
+  }
+
+  void chunk()
+  {
+    const size_t num_elements = seeds_.size();
+    cumulative_costs_.resize(num_elements + 1);
+    cumulative_costs_[0] = 0.;
+    for (size_t ii = 0; ii < num_elements; ++ii) {
+      if (costs_[ii] < 0.)
+        DUNE_THROW(Common::Exceptions::wrong_input_given, "Costs have to be non-negative, given: " << costs_[ii]);
+      cumulative_costs_[ii + 1] = cumulative_costs_[ii] + costs_[ii];
+    }
+    const double total_cost = cumulative_costs_[num_elements];
+    const size_t num_partitions = std::max(size_t(1), std::min(size_t(num_partitions_), num_elements));
+    entry_points_.clear();
+    entry_points_.reserve(num_partitions + 1);
+    entry_points_.push_back(0);
+    for (size_t pp = 1; pp < num_partitions; ++pp) {
+      size_t entry_point = pp * num_elements / num_partitions;
+      if (total_cost > 0.)
+        entry_point = std::lower_bound(cumulative_costs_.begin(),
+                                       cumulative_costs_.end(),
+                                       (total_cost * pp) / num_partitions)
+                      - cumulative_costs_.begin();
+      // each partition should contain at least one element
+      entry_point = std::max(entry_point, entry_points_.back() + 1);
+      entry_point = std::min(entry_point, num_elements - (num_partitions - pp));
+      entry_points_.push_back(entry_point);
+    }
+    entry_points_.push_back(num_elements);
+  } // ... chunk(...)
+
+  const GridLayerType grid_layer_;
+  const Size num_partitions_;
+  std::vector<EntitySeedType> seeds_;
+  std::vector<size_t> indices_;
+  std::vector<double> costs_;
+  std::vector<double> cumulative_costs_;
+  std::vector<size_t> entry_points_;
+}; // class WeightedPartitioning
+
+
+/**
+ * \brief Range of elements of consecutive partitions of a WeightedPartitioning, can be split by TBB.
+ */
+template <class GridLayerImp>
+class WeightedPartitioning<GridLayerImp>::Partition
+{
+  typedef typename std::vector<EntitySeedType>::const_iterator SeedIteratorType;
+
+public:
+  typedef typename WeightedPartitioning<GridLayerImp>::EntityType Entity;
+  typedef typename WeightedPartitioning<GridLayerImp>::Size Size;
+
+  //! Creates the elements from their seeds
+  class Iterator
+  {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef Entity value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const Entity* pointer;
+    typedef Entity reference;
+
+    Iterator(const GridLayerType& grid_layer, SeedIteratorType seed_iterator)
+      : grid_layer_(&grid_layer)
+      , seed_iterator_(seed_iterator)
+    {
+    }
+
+    Entity operator*() const
+    {
+      return entity_from_seed(*grid_layer_, *seed_iterator_);
+    }
+
+    Iterator& operator++()
+    {
+      ++seed_iterator_;
+      return *this;
+    }
+
+    bool operator==(const Iterator& other) const
+    {
+      return seed_iterator_ == other.seed_iterator_;
+    }
+
+    bool operator!=(const Iterator& other) const
+    {
+      return seed_iterator_ != other.seed_iterator_;
+    }
+
+  private:
+    const GridLayerType* grid_layer_;
+    SeedIteratorType seed_iterator_;
+  }; // class Iterator
+
+  Partition(const WeightedPartitioning& partitioning, Size firstPartition, Size lastPartition)
+    : partitioning_(partitioning)
+    , firstPartition_(firstPartition)
+    , lastPartition_(lastPartition)
+  {
+  }
+
+  Iterator begin() const
+  {
+    return Iterator(partitioning_.grid_layer_,
+                    partitioning_.seeds_.begin() + partitioning_.entry_points_[firstPartition_]);
+  }
+
+  Iterator end() const
+  {
+    return Iterator(partitioning_.grid_layer_,
+                    partitioning_.seeds_.begin() + partitioning_.entry_points_[lastPartition_]);
+  }
+
+  //! Number of elements
+  Size size() const
+  {
+    return partitioning_.entry_points_[lastPartition_] - partitioning_.entry_points_[firstPartition_];
+  }
+
+#if HAVE_TBB
+  //! Splits by cost, \sa RangedPartitioning::Partition
+  Partition(Partition& other, tbb::split)
+    : partitioning_(other.partitioning_)
+  {
+    const double half_cost = partitioning_.cost(other.firstPartition_, other.lastPartition_) / 2.;
+    firstPartition_ = other.firstPartition_ + 1;
+    while (firstPartition_ + 1 < other.lastPartition_
+           && partitioning_.cost(other.firstPartition_, firstPartition_) < half_cost)
+      ++firstPartition_;
+    lastPartition_ = other.lastPartition_;
+    other.lastPartition_ = firstPartition_;
+  }
+
+  bool empty() const
+  {
+    return size() == 0;
+  }
+
+  bool is_divisible() const
+  {
+    return lastPartition_ - firstPartition_ > 1;
+  }
+#endif // HAVE_TBB
+
+private:
+  const WeightedPartitioning& partitioning_;
+  Size firstPartition_;
+  Size lastPartition_;
+}; // class WeightedPartitioning::Partition
+
+
+} // namespace Grid
+} // namespace XT
+} // namespace Dune
+
+#endif // DUNE_XT_GRID_PARALLEL_PARTITIONING_WEIGHTED_HH
@@ -45,6 +45,80 @@ public:
 }; // class EntitySearchBase
 
 
+/**
+ * \brief Compact result of a codim 0 point search, without any entity or heap allocation.
+ *
+ * The element containing the point may be obtained by entity_from_seed(grid_layer, seed), local is the local
+ * coordinate of the point within this element, as computed by the search.
+ * \sa EntityBoundingBoxSearch::locate, EntityStructuredSearch::locate
+ */
+template <class GridLayerType>
+struct EntitySearchResult
+{
+  static_assert(is_layer<GridLayerType>::value, "");
+  typedef typename extract_entity_t<GridLayerType>::EntitySeed EntitySeedType;
+  typedef typename extract_entity_t<GridLayerType>::Geometry::LocalCoordinate LocalCoordinateType;
+
+  //! false if the point is not contained in any element of the grid layer, all other members are invalid then
+  bool found = false;
+  //! index of the element in the index set of the grid layer
+  size_t index = 0;
+  EntitySeedType seed;
+  LocalCoordinateType local;
+}; // struct EntitySearchResult
+
+
+/**
+ * \brief Base of the codim 0 searches which locate each point on its own, provides the searches for sequences of
+ *        points.
+ *
+ * Derived has to provide find(point) and locate(point, result) and has to pull locate into its scope (using).
+ * \sa EntityBoundingBoxSearch, EntityStructuredSearch
+ */
+template <class GridLayerType, class Derived>
+class EntityPointSearchBase : public EntitySearchBase<GridLayerType>
+{
+  typedef EntitySearchBase<GridLayerType> BaseType;
+
+public:
+  using typename BaseType::EntityVectorType;
+  typedef EntitySearchResult<GridLayerType> ResultType;
+
+  /** \arg points iterable sequence of global coordinates to search for
+   *  \return a vector of size points.size() of, potentially nullptr if no corresponding one was found,
+   *          unique_ptr<Entity>
+   **/
+  template <class PointContainerType>
+  EntityVectorType operator()(const PointContainerType& points) const
+  {
+    EntityVectorType ret;
+    ret.reserve(points.size());
+    for (const auto& point : points)
+      ret.emplace_back(as_derived().find(point));
+    return ret;
+  }
+
+  /** \arg points iterable sequence of global coordinates to search for
+   *  \return a vector of size points.size() of compact results, \sa EntitySearchResult
+   **/
+  template <class PointContainerType>
+  std::vector<ResultType> locate(const PointContainerType& points) const
+  {
+    std::vector<ResultType> ret(points.size());
+    size_t ii = 0;
+    for (const auto& point : points)
+      as_derived().locate(point, ret[ii++]);
+    return ret;
+  }
+
+private:
+  const Derived& as_derived() const
+  {
+    return static_cast<const Derived&>(*this);
+  }
+}; // class EntityPointSearchBase
+
+
 template <int codim>
 struct CheckInside
 {
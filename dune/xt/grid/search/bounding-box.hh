@@ -0,0 +1,253 @@
+// This file is part of the dune-xt-grid project:
+//   https://github.com/dune-community/dune-xt-grid
+// Copyright 2009-2018 dune-xt-grid developers and contributors. All rights reserved.
+// License: Dual licensed as BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+//      or  GPL-2.0+ (http://opensource.org/licenses/gpl-license)
+//          with "runtime exception" (http://www.dune-project.org/license.html)
+
+#ifndef DUNE_XT_GRID_SEARCH_BOUNDING_BOX_HH
+#define DUNE_XT_GRID_SEARCH_BOUNDING_BOX_HH
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include <dune/grid/common/rangegenerators.hh>
+
+#include <dune/xt/common/memory.hh>
+#include <dune/xt/grid/search.hh>
+#include <dune/xt/grid/type_traits.hh>
+
+namespace Dune {
+namespace XT {
+namespace Grid {
+
+
+/**
+ * \brief Searches a grid layer for the elements containing given points, using a bounding volume hierarchy.
+ *
+ * On construction, an axis aligned bounding box tree over the geometries of all elements of the grid layer is built
+ * (in O(N log N), by recursively splitting the elements at the median of their centers along the longest axis). Each
+ * point is then located in O(log N), only the few elements whose bounding boxes contain the point are checked.
+ *
+ * Only the seeds and indices of the elements are stored, all searches are const and may thus be carried out
+ * concurrently. Use locate() instead of find() or operator() to avoid the allocation of an entity per point.
+ * \note The bounding boxes are spanned by the corners of the element geometries, non-affine geometries which bulge out
+ *       beyond their corners are thus not supported.
+ * \sa EntityInlevelSearch
+ */
+template <class GridLayerType>
+class EntityBoundingBoxSearch : public EntityPointSearchBase<GridLayerType, EntityBoundingBoxSearch<GridLayerType>>
+{
+  typedef EntityPointSearchBase<GridLayerType, EntityBoundingBoxSearch<GridLayerType>> BaseType;
+
+public:
+  using typename BaseType::EntityType;
+  using typename BaseType::GlobalCoordinateType;
+  using typename BaseType::EntityVectorType;
+  typedef typename EntityType::EntitySeed EntitySeedType;
+  using typename BaseType::ResultType;
+  using BaseType::locate;
+
+private:
+  typedef typename GlobalCoordinateType::value_type D;
+  static const constexpr size_t dimDomain = GlobalCoordinateType::dimension;
+
+  struct BoundingBox
+  {
+    bool contains(const GlobalCoordinateType& point) const
+    {
+      for (size_t dd = 0; dd < dimDomain; ++dd)
+        if (point[dd] < lower[dd] || point[dd] > upper[dd])
+          return false;
+      return true;
+    }
+
+    void merge(const BoundingBox& other)
+    {
+      for (size_t dd = 0; dd < dimDomain; ++dd) {
+        lower[dd] = std::min(lower[dd], other.lower[dd]);
+        upper[dd] = std::max(upper[dd], other.upper[dd]);
+      }
+    }
+
+    GlobalCoordinateType lower;
+    GlobalCoordinateType upper;
+  }; // struct BoundingBox
+
+  // the elements of the subtree below a node are [begin, end) in seeds_, the left child directly follows its father
+  struct Node
+  {
+    BoundingBox box;
+    size_t begin;
+    size_t end;
+    size_t right; // 0 for leafs
+  }; // struct Node
+
+public:
+  explicit EntityBoundingBoxSearch(const GridLayerType& grid_layer, const size_t max_elements_per_leaf = 4)
+    : grid_layer_(grid_layer)
+    , max_elements_per_leaf_(std::max(max_elements_per_leaf, size_t(1)))
+  {
+    const auto& index_set = grid_layer_.indexSet();
+    std::vector<EntitySeedType> seeds;
+    std::vector<size_t> indices;
+    std::vector<BoundingBox> boxes;
+    std::vector<GlobalCoordinateType> centers;
+    for (auto&& element : elements(grid_layer_)) {
+      const auto geometry = element.geometry();
+      BoundingBox box{geometry.corner(0), geometry.corner(0)};
+      for (int cc = 1; cc < geometry.corners(); ++cc)
+        box.merge({geometry.corner(cc), geometry.corner(cc)});
+      // enlarge each box slightly, to find points on the boundary of an element despite rounding errors
+      D tolerance = 0.;
+      for (size_t dd = 0; dd < dimDomain; ++dd)
+        tolerance = std::max(tolerance, box.upper[dd] - box.lower[dd]);
+      tolerance *= 1e-10;
+      for (size_t dd = 0; dd < dimDomain; ++dd) {
+        box.lower[dd] -= tolerance;
+        box.upper[dd] += tolerance;
+      }
+      seeds.emplace_back(element.seed());
+      indices.emplace_back(index_set.index(element));
+      boxes.emplace_back(box);
+      centers.emplace_back(geometry.center());
+    }
+    std::vector<size_t> order(seeds.size());
+    std::iota(order.begin(), order.end(), 0);
+    if (!order.empty())
+      build(order, boxes, centers, 0, order.size());
+    // store the elements in the order of the leafs
+    seeds_.reserve(order.size());
+    indices_.reserve(order.size());
+    boxes_.reserve(order.size());
+    for (const auto& ii : order) {
+      seeds_.emplace_back(seeds[ii]);
+      indices_.emplace_back(indices[ii]);
+      boxes_.emplace_back(boxes[ii]);
+    }
+  } // EntityBoundingBoxSearch(...)
+
+  const GridLayerType& grid_layer() const
+  {
+    return grid_layer_;
+  }
+
+  /**
+   * \return the first element found to contain point, nullptr if there is none
+   */
+  std::unique_ptr<EntityType> find(const GlobalCoordinateType& point) const
+  {
+    std::unique_ptr<EntityType> ret;
+    visit_candidates(point, [&](const size_t ii) {
+      auto element = entity_from_seed(grid_layer_, seeds_[ii]);
+      if (!CheckInside<0>::check(element.geometry(), point))
+        return false;
+      ret = Common::make_unique<EntityType>(std::move(element));
+      return true;
+    });
+    return ret;
+  } // ... find(...)
+
+  /**
+   * \brief Locates point without allocating an entity, the local coordinate computed for the inside check is kept.
+   * \return result.found
+   */
+  bool locate(const GlobalCoordinateType& point, ResultType& result) const
+  {
+    result = ResultType();
+    result.found = visit_candidates(point, [&](const size_t ii) {
+      const auto geometry = entity_from_seed(grid_layer_, seeds_[ii]).geometry();
+      result.local = geometry.local(point);
+      if (!reference_element(geometry).checkInside(result.local))
+        return false;
+      result.index = indices_[ii];
+      result.seed = seeds_[ii];
+      return true;
+    });
+    return result.found;
+  } // ... locate(...)
+
+protected:
+  size_t build(std::vector<size_t>& order,
+               const std::vector<BoundingBox>& boxes,
+               const std::vector<GlobalCoordinateType>& centers,
+               const size_t begin,
+               const size_t end)
+  {
+    const size_t node = nodes_.size();
+    nodes_.push_back({boxes[order[begin]], begin, end, 0});
+    BoundingBox center_box{centers[order[begin]], centers[order[begin]]};
+    for (size_t ii = begin + 1; ii < end; ++ii) {
+      nodes_[node].box.merge(boxes[order[ii]]);
+      center_box.merge({centers[order[ii]], centers[order[ii]]});
+    }
+    if (end - begin <= max_elements_per_leaf_)
+      return node;
+    size_t axis = 0;
+    for (size_t dd = 1; dd < dimDomain; ++dd)
+      if (center_box.upper[dd] - center_box.lower[dd] > center_box.upper[axis] - center_box.lower[axis])
+        axis = dd;
+    const size_t middle = begin + (end - begin) / 2;
+    std::nth_element(order.begin() + begin,
+                     order.begin() + middle,
+                     order.begin() + end,
+                     [&](const size_t& ii, const size_t& jj) { return centers[ii][axis] < centers[jj][axis]; });
+    build(order, boxes, centers, begin, middle);
+    const size_t right = build(order, boxes, centers, middle, end);
+    nodes_[node].right = right;
+    return node;
+  } // ... build(...)
+
+  /**
+   * Calls visitor(ii) for each element ii in seeds_ whose bounding box contains point, until visitor returns true.
+   * \return true if visitor returned true
+   */
+  template <class VisitorType>
+  bool visit_candidates(const GlobalCoordinateType& point, VisitorType&& visitor) const
+  {
+    if (nodes_.empty())
+      return false;
+    // the median split bounds the depth of the tree by log2 of the number of elements
+    std::array<size_t, 8 * sizeof(size_t) + 1> stack;
+    size_t stack_size = 0;
+    stack[stack_size++] = 0;
+    while (stack_size > 0) {
+      const auto& node = nodes_[stack[--stack_size]];
+      if (!node.box.contains(point))
+        continue;
+      if (node.right == 0) {
+        for (size_t ii = node.begin; ii < node.end; ++ii)
+          if (boxes_[ii].contains(point) && visitor(ii))
+            return true;
+      } else {
+        stack[stack_size++] = node.right;
+        stack[stack_size++] = &node - nodes_.data() + 1;
+      }
+    }
+    return false;
+  } // ... visit_candidates(...)
+
+  const GridLayerType grid_layer_;
+  const size_t max_elements_per_leaf_;
+  std::vector<Node> nodes_;
+  std::vector<EntitySeedType> seeds_;
+  std::vector<size_t> indices_;
+  std::vector<BoundingBox> boxes_;
+}; // class EntityBoundingBoxSearch
+
+
+template <class GV>
+EntityBoundingBoxSearch<GV> make_entity_bounding_box_search(const GV& grid_view)
+{
+  return EntityBoundingBoxSearch<GV>(grid_view);
+}
+
+
+} // namespace Grid
+} // namespace XT
+} // namespace Dune
+
+#endif // DUNE_XT_GRID_SEARCH_BOUNDING_BOX_HH
@@ -0,0 +1,144 @@
+// This file is part of the dune-xt-grid project:
+//   https://github.com/dune-community/dune-xt-grid
+// Copyright 2009-2018 dune-xt-grid developers and contributors. All rights reserved.
+// License: Dual licensed as BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+//      or  GPL-2.0+ (http://opensource.org/licenses/gpl-license)
+//          with "runtime exception" (http://www.dune-project.org/license.html)
+
+#ifndef DUNE_XT_GRID_SEARCH_NEIGHBOR_WALK_HH
+#define DUNE_XT_GRID_SEARCH_NEIGHBOR_WALK_HH
+
+#include <memory>
+
+#include <dune/xt/common/memory.hh>
+#include <dune/xt/grid/entity.hh>
+#include <dune/xt/grid/search.hh>
+#include <dune/xt/grid/search/structured.hh>
+#include <dune/xt/grid/type_traits.hh>
+
+namespace Dune {
+namespace XT {
+namespace Grid {
+
+
+/**
+ * \brief Locates points close to a known (hint) element by walking from element to neighbor towards the point, e.g.
+ *        for particle tracking or streamline integration.
+ *
+ * Starting at the hint element, the walk leaves each element through the intersection which separates it the most
+ * from the point (the "visibility walk"), until an element containing the point is found. The cost is thus
+ * proportional to the distance between hint and point in elements. If the walk hits the domain boundary (e.g. for
+ * non-convex domains) or exceeds max_steps (e.g. for periodic grid layers), the point is located by the given global
+ * search instead, which is built once on construction.
+ *
+ * All searches are const and may thus be carried out concurrently. In particular, locate_entities() with the results
+ * of the last step continues each walk at the element found before.
+ * \sa EntityBoundingBoxSearch, EntityStructuredSearch
+ */
+template <class GridLayerType, class GlobalSearchType = EntitySearch<GridLayerType>>
+class EntityNeighborWalkSearch : public EntitySearchBase<GridLayerType>
+{
+  typedef EntitySearchBase<GridLayerType> BaseType;
+
+public:
+  using typename BaseType::EntityType;
+  using typename BaseType::GlobalCoordinateType;
+  typedef EntitySearchResult<GridLayerType> ResultType;
+
+  explicit EntityNeighborWalkSearch(const GridLayerType& grid_layer, const size_t max_steps = 100)
+    : grid_layer_(grid_layer)
+    , max_steps_(max_steps)
+    , global_search_(grid_layer_)
+  {
+  }
+
+  const GridLayerType& grid_layer() const
+  {
+    return grid_layer_;
+  }
+
+  const GlobalSearchType& global_search() const
+  {
+    return global_search_;
+  }
+
+  /**
+   * \brief Walks from hint towards point.
+   * \return result.found
+   */
+  bool locate(const GlobalCoordinateType& point, const EntityType& hint, ResultType& result) const
+  {
+    EntityType element = hint;
+    for (size_t step = 0; step <= max_steps_; ++step) {
+      const auto geometry = element.geometry();
+      result.local = geometry.local(point);
+      if (reference_element(geometry).checkInside(result.local)) {
+        result.found = true;
+        result.index = grid_layer_.indexSet().index(element);
+        result.seed = element.seed();
+        return true;
+      }
+      // leave through the intersection the point lies furthest beyond
+      typename GlobalCoordinateType::value_type max_distance = 0.;
+      bool leaves_domain = true;
+      EntityType next = element;
+      const auto intersection_it_end = grid_layer_.iend(element);
+      for (auto intersection_it = grid_layer_.ibegin(element); intersection_it != intersection_it_end;
+           ++intersection_it) {
+        const auto& intersection = *intersection_it;
+        const auto distance = (point - intersection.geometry().center()) * intersection.centerUnitOuterNormal();
+        if (distance > max_distance) {
+          max_distance = distance;
+          leaves_domain = !intersection.neighbor();
+          if (!leaves_domain)
+            next = intersection.outside();
+        }
+      }
+      if (leaves_domain)
+        break;
+      element = next;
+    }
+    return global_search_.locate(point, result);
+  } // ... locate(...)
+
+  /**
+   * \brief Walks towards point from the element of result, if result.found, uses the global search otherwise.
+   * \return result.found
+   */
+  bool locate(const GlobalCoordinateType& point, ResultType& result) const
+  {
+    if (!result.found)
+      return global_search_.locate(point, result);
+    return locate(point, entity_from_seed(grid_layer_, result.seed), result);
+  }
+
+  /**
+   * \return the element containing point, found by walking from hint, nullptr if there is none
+   */
+  std::unique_ptr<EntityType> find(const GlobalCoordinateType& point, const EntityType& hint) const
+  {
+    ResultType result;
+    if (!locate(point, hint, result))
+      return nullptr;
+    return Common::make_unique<EntityType>(entity_from_seed(grid_layer_, result.seed));
+  }
+
+private:
+  const GridLayerType grid_layer_;
+  const size_t max_steps_;
+  const GlobalSearchType global_search_;
+}; // class EntityNeighborWalkSearch
+
+
+template <class GV>
+EntityNeighborWalkSearch<GV> make_entity_neighbor_walk_search(const GV& grid_view, const size_t max_steps = 100)
+{
+  return EntityNeighborWalkSearch<GV>(grid_view, max_steps);
+}
+
+
+} // namespace Grid
+} // namespace XT
+} // namespace Dune
+
+#endif // DUNE_XT_GRID_SEARCH_NEIGHBOR_WALK_HH
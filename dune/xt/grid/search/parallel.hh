@@ -0,0 +1,110 @@
+// This file is part of the dune-xt-grid project:
+//   https://github.com/dune-community/dune-xt-grid
+// Copyright 2009-2018 dune-xt-grid developers and contributors. All rights reserved.
+// License: Dual licensed as BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+//      or  GPL-2.0+ (http://opensource.org/licenses/gpl-license)
+//          with "runtime exception" (http://www.dune-project.org/license.html)
+
+#ifndef DUNE_XT_GRID_SEARCH_PARALLEL_HH
+#define DUNE_XT_GRID_SEARCH_PARALLEL_HH
+
+#include <algorithm>
+#include <vector>
+
+#if HAVE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
+#include <dune/common/unused.hh>
+
+#include <dune/xt/common/configuration.hh>
+#include <dune/xt/common/exceptions.hh>
+#include <dune/xt/common/parallel/threadmanager.hh>
+#include <dune/xt/grid/search/bounding-box.hh>
+#include <dune/xt/grid/search/structured.hh>
+
+namespace Dune {
+namespace XT {
+namespace Grid {
+namespace internal {
+
+
+//! Calls functor(ii) for all 0 <= ii < num_points, in chunks distributed among the threads if use_tbb is true.
+template <class FunctorType>
+void for_each_point(const size_t num_points, const bool use_tbb, FunctorType&& functor)
+{
+#if HAVE_TBB
+  if (use_tbb) {
+    // many chunks of the same size, distributed among the threads by work stealing (as in Walker::walk)
+    const size_t num_partitions =
+        DXTC_CONFIG_GET("threading.partition_factor", 8u) * XT::Common::threadManager().current_threads();
+    const size_t grain_size = std::max(num_points / std::max(num_partitions, size_t(1)), size_t(1));
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_points, grain_size),
+                      [&](const tbb::blocked_range<size_t>& range) {
+                        for (size_t ii = range.begin(); ii != range.end(); ++ii)
+                          functor(ii);
+                      });
+    return;
+  }
+#else
+  DUNE_UNUSED_PARAMETER(use_tbb);
+#endif
+  for (size_t ii = 0; ii < num_points; ++ii)
+    functor(ii);
+} // ... for_each_point(...)
+
+
+} // namespace internal
+
+
+/**
+ * \brief Locates a large number of points in parallel, results[ii] is set to the element containing points[ii] (or
+ *        nullptr, if there is none).
+ *
+ * The points are split into chunks which are distributed among the threads, all of which share the read-only index of
+ * the given search. Any search with a const and thread safe find(point) may thus be used, i.e. EntityBoundingBoxSearch
+ * and EntityStructuredSearch (\sa make_entity_search), but not EntityInlevelSearch, FallbackEntityInlevelSearch or
+ * EntityHierarchicSearch.
+ * \note results has to be preallocated with points.size() entries, points has to provide random access.
+ */
+template <class SearchType, class PointContainerType>
+void find_entities(const SearchType& search,
+                   const PointContainerType& points,
+                   typename SearchType::EntityVectorType& results,
+                   const bool use_tbb = true)
+{
+  if (results.size() != points.size())
+    DUNE_THROW(Common::Exceptions::shapes_do_not_match,
+               "results has to be of the same size as points!\n   results.size() = " << results.size()
+                                                                                     << "\n   points.size() = "
+                                                                                     << points.size());
+  internal::for_each_point(points.size(), use_tbb, [&](const size_t ii) { results[ii] = search.find(points[ii]); });
+}
+
+
+/**
+ * \brief Like find_entities, but fills results with the compact results of search.locate(), without allocating an
+ *        entity per point.
+ * \sa EntitySearchResult
+ */
+template <class SearchType, class PointContainerType>
+void locate_entities(const SearchType& search,
+                     const PointContainerType& points,
+                     std::vector<typename SearchType::ResultType>& results,
+                     const bool use_tbb = true)
+{
+  if (results.size() != points.size())
+    DUNE_THROW(Common::Exceptions::shapes_do_not_match,
+               "results has to be of the same size as points!\n   results.size() = " << results.size()
+                                                                                     << "\n   points.size() = "
+                                                                                     << points.size());
+  internal::for_each_point(points.size(), use_tbb, [&](const size_t ii) { search.locate(points[ii], results[ii]); });
+}
+
+
+} // namespace Grid
+} // namespace XT
+} // namespace Dune
+
+#endif // DUNE_XT_GRID_SEARCH_PARALLEL_HH
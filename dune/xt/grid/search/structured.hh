@@ -0,0 +1,287 @@
+// This file is part of the dune-xt-grid project:
+//   https://github.com/dune-community/dune-xt-grid
+// Copyright 2009-2018 dune-xt-grid developers and contributors. All rights reserved.
+// License: Dual licensed as BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+//      or  GPL-2.0+ (http://opensource.org/licenses/gpl-license)
+//          with "runtime exception" (http://www.dune-project.org/license.html)
+
+#ifndef DUNE_XT_GRID_SEARCH_STRUCTURED_HH
+#define DUNE_XT_GRID_SEARCH_STRUCTURED_HH
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <dune/grid/common/rangegenerators.hh>
+
+#include <dune/xt/common/exceptions.hh>
+#include <dune/xt/common/memory.hh>
+#include <dune/xt/grid/grids.hh>
+#include <dune/xt/grid/search.hh>
+#include <dune/xt/grid/search/bounding-box.hh>
+#include <dune/xt/grid/type_traits.hh>
+
+namespace Dune {
+namespace XT {
+namespace Grid {
+namespace internal {
+
+
+//! Grids whose elements on each level are axis aligned cubes of the same size.
+template <class T>
+struct is_equidistant_cube_grid : public std::false_type
+{
+};
+
+template <int dim, class ct>
+struct is_equidistant_cube_grid<Dune::YaspGrid<dim, Dune::EquidistantCoordinates<ct, dim>>> : public std::true_type
+{
+};
+
+template <int dim, class ct>
+struct is_equidistant_cube_grid<Dune::YaspGrid<dim, Dune::EquidistantOffsetCoordinates<ct, dim>>>
+    : public std::true_type
+{
+};
+
+#if HAVE_DUNE_SPGRID
+
+template <class ct, int dim, template <int> class Ref, class Comm>
+struct is_equidistant_cube_grid<Dune::SPGrid<ct, dim, Ref, Comm>> : public std::true_type
+{
+};
+
+#endif // HAVE_DUNE_SPGRID
+
+
+} // namespace internal
+
+
+/**
+ * \brief Searches a grid layer of axis aligned cubes of the same size for the elements containing given points.
+ *
+ * On construction, the bounding box and the cell counts of the grid layer are determined and each cell is associated
+ * with the seed of its element. The cell containing a point is then computed arithmetically from its coordinates, each
+ * point is thus located in O(1), without any calls to geometry.local() (also for the local coordinates computed by
+ * locate(), which are obtained arithmetically as well).
+ *
+ * Any grid layer of such elements is supported (e.g. level and leaf views of YaspGrid with equidistant coordinates or
+ * SPGrid, also subdomains or periodic views thereof), the bounding box need not be completely covered by elements.
+ * Only the seeds and indices of the elements are stored, all searches are const and may thus be carried out
+ * concurrently. Use locate() instead of find() or operator() to avoid the allocation of an entity per point.
+ * \note Throws Common::Exceptions::wrong_input_given on construction for any other grid layer, use
+ *       make_entity_search() to choose the fastest search for a given grid layer.
+ * \sa EntityBoundingBoxSearch
+ */
+template <class GridLayerType>
+class EntityStructuredSearch : public EntityPointSearchBase<GridLayerType, EntityStructuredSearch<GridLayerType>>
+{
+  typedef EntityPointSearchBase<GridLayerType, EntityStructuredSearch<GridLayerType>> BaseType;
+
+public:
+  using typename BaseType::EntityType;
+  using typename BaseType::GlobalCoordinateType;
+  using typename BaseType::LocalCoordinateType;
+  using typename BaseType::EntityVectorType;
+  typedef typename EntityType::EntitySeed EntitySeedType;
+  using typename BaseType::ResultType;
+  using BaseType::locate;
+
+private:
+  typedef typename GlobalCoordinateType::value_type D;
+  static const constexpr size_t dimDomain = GlobalCoordinateType::dimension;
+  static const constexpr size_t no_element = std::numeric_limits<size_t>::max();
+  static_assert(LocalCoordinateType::dimension == dimDomain, "Only available for elements of full dimension!");
+
+public:
+  explicit EntityStructuredSearch(const GridLayerType& grid_layer)
+    : grid_layer_(grid_layer)
+  {
+    static const constexpr D tolerance = 1e-10;
+    const auto& index_set = grid_layer_.indexSet();
+    std::vector<GlobalCoordinateType> lower_corners;
+    std::fill(lower_left_.begin(), lower_left_.end(), std::numeric_limits<D>::max());
+    std::fill(upper_right_.begin(), upper_right_.end(), std::numeric_limits<D>::lowest());
+    for (auto&& element : elements(grid_layer_)) {
+      const auto geometry = element.geometry();
+      if (!element.type().isCube() || geometry.corners() != (1 << dimDomain))
+        DUNE_THROW(Common::Exceptions::wrong_input_given, "All elements of the grid layer have to be cubes!");
+      auto lower = geometry.corner(0);
+      auto upper = geometry.corner(0);
+      for (int cc = 1; cc < geometry.corners(); ++cc)
+        for (size_t dd = 0; dd < dimDomain; ++dd) {
+          lower[dd] = std::min(lower[dd], geometry.corner(cc)[dd]);
+          upper[dd] = std::max(upper[dd], geometry.corner(cc)[dd]);
+        }
+      for (size_t dd = 0; dd < dimDomain; ++dd) {
+        if (seeds_.empty())
+          cell_width_[dd] = upper[dd] - lower[dd];
+        else if (std::abs(upper[dd] - lower[dd] - cell_width_[dd]) > tolerance * cell_width_[dd])
+          DUNE_THROW(Common::Exceptions::wrong_input_given,
+                     "All elements of the grid layer have to be axis aligned cubes of the same size!");
+        lower_left_[dd] = std::min(lower_left_[dd], lower[dd]);
+        upper_right_[dd] = std::max(upper_right_[dd], upper[dd]);
+      }
+      if (std::abs(geometry.volume() - volume(upper - lower)) > tolerance * volume(upper - lower))
+        DUNE_THROW(Common::Exceptions::wrong_input_given, "All elements of the grid layer have to be axis aligned!");
+      // the local coordinates are computed arithmetically, they thus have to be aligned with the global ones
+      for (size_t dd = 0; dd < dimDomain; ++dd)
+        if (std::abs(geometry.corner(0)[dd] - lower[dd]) > tolerance * cell_width_[dd]
+            || std::abs(geometry.corner(1 << dd)[dd] - upper[dd]) > tolerance * cell_width_[dd])
+          DUNE_THROW(Common::Exceptions::wrong_input_given,
+                     "The local coordinates of all elements have to be aligned with the global coordinates!");
+      seeds_.emplace_back(element.seed());
+      indices_.emplace_back(index_set.index(element));
+      lower_corners.emplace_back(lower);
+    }
+    if (seeds_.empty())
+      return;
+    size_t num_cells = 1;
+    for (size_t dd = 0; dd < dimDomain; ++dd) {
+      num_cells_[dd] = size_t(std::round((upper_right_[dd] - lower_left_[dd]) / cell_width_[dd]));
+      num_cells *= num_cells_[dd];
+    }
+    cells_.resize(num_cells, no_element);
+    LocalCoordinateType local;
+    for (size_t ii = 0; ii < seeds_.size(); ++ii) {
+      auto& cell = cells_[cell_of(lower_corners[ii], 0.5, local)];
+      if (cell != no_element)
+        DUNE_THROW(Common::Exceptions::wrong_input_given, "The elements of the grid layer must not overlap!");
+      cell = ii;
+    }
+  } // EntityStructuredSearch(...)
+
+  const GridLayerType& grid_layer() const
+  {
+    return grid_layer_;
+  }
+
+  /**
+   * \return the element containing point, nullptr if there is none
+   */
+  std::unique_ptr<EntityType> find(const GlobalCoordinateType& point) const
+  {
+    LocalCoordinateType local;
+    const auto ii = element_of(point, local);
+    if (ii == no_element)
+      return nullptr;
+    return Common::make_unique<EntityType>(entity_from_seed(grid_layer_, seeds_[ii]));
+  }
+
+  /**
+   * \brief Locates point without allocating an entity, the local coordinate is computed arithmetically.
+   * \return result.found
+   */
+  bool locate(const GlobalCoordinateType& point, ResultType& result) const
+  {
+    result = ResultType();
+    const auto ii = element_of(point, result.local);
+    result.found = (ii != no_element);
+    if (result.found) {
+      result.index = indices_[ii];
+      result.seed = seeds_[ii];
+    }
+    return result.found;
+  } // ... locate(...)
+
+protected:
+  static D volume(const GlobalCoordinateType& extents)
+  {
+    D ret = 1.;
+    for (size_t dd = 0; dd < dimDomain; ++dd)
+      ret *= extents[dd];
+    return ret;
+  }
+
+  /**
+   * Lexicographic index of the cell containing point + shift * cell_width_, which has to lie inside the bounding box.
+   * local is set to the local coordinate of point in this cell.
+   */
+  size_t cell_of(const GlobalCoordinateType& point, const D shift, LocalCoordinateType& local) const
+  {
+    size_t ret = 0;
+    for (size_t dd = dimDomain; dd > 0; --dd) {
+      const auto xx = (point[dd - 1] - lower_left_[dd - 1]) / cell_width_[dd - 1];
+      const auto ii = std::min(size_t(std::max(std::floor(xx + shift), D(0))), num_cells_[dd - 1] - 1);
+      local[dd - 1] = xx - ii;
+      ret = ret * num_cells_[dd - 1] + ii;
+    }
+    return ret;
+  } // ... cell_of(...)
+
+  //! Position of the element containing point in seeds_, no_element if there is none, \sa cell_of
+  size_t element_of(const GlobalCoordinateType& point, LocalCoordinateType& local) const
+  {
+    if (seeds_.empty())
+      return no_element;
+    // points on the boundary of the bounding box (up to rounding errors) belong to the adjacent cells
+    for (size_t dd = 0; dd < dimDomain; ++dd) {
+      const auto tolerance = 1e-10 * cell_width_[dd];
+      if (point[dd] < lower_left_[dd] - tolerance || point[dd] > upper_right_[dd] + tolerance)
+        return no_element;
+    }
+    return cells_[cell_of(point, 0., local)];
+  }
+
+  const GridLayerType grid_layer_;
+  std::array<D, dimDomain> lower_left_;
+  std::array<D, dimDomain> upper_right_;
+  std::array<D, dimDomain> cell_width_;
+  std::array<size_t, dimDomain> num_cells_;
+  std::vector<EntitySeedType> seeds_;
+  std::vector<size_t> indices_;
+  std::vector<size_t> cells_;
+}; // class EntityStructuredSearch
+
+
+namespace internal {
+
+
+template <class GridLayerType, bool structured = is_equidistant_cube_grid<extract_grid_t<GridLayerType>>::value>
+struct ChooseEntitySearch
+{
+  typedef EntityBoundingBoxSearch<GridLayerType> type;
+};
+
+template <class GridLayerType>
+struct ChooseEntitySearch<GridLayerType, true>
+{
+  typedef EntityStructuredSearch<GridLayerType> type;
+};
+
+
+} // namespace internal
+
+
+//! The fastest codim 0 search for the given grid layer, EntityStructuredSearch if possible.
+template <class GridLayerType>
+using EntitySearch = typename internal::ChooseEntitySearch<GridLayerType>::type;
+
+
+template <class GV>
+EntityStructuredSearch<GV> make_entity_structured_search(const GV& grid_view)
+{
+  return EntityStructuredSearch<GV>(grid_view);
+}
+
+
+/**
+ * \brief Creates an EntityStructuredSearch for level and leaf views of equidistant YaspGrids and SPGrids, an
+ *        EntityBoundingBoxSearch otherwise.
+ */
+template <class GV>
+EntitySearch<GV> make_entity_search(const GV& grid_view)
+{
+  return EntitySearch<GV>(grid_view);
+}
+
+
+} // namespace Grid
+} // namespace XT
+} // namespace Dune
+
+#endif // DUNE_XT_GRID_SEARCH_STRUCTURED_HH
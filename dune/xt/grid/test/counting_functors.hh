@@ -0,0 +1,97 @@
+// This file is part of the dune-xt-grid project:
+//   https://github.com/dune-community/dune-xt-grid
+// Copyright 2009-2018 dune-xt-grid developers and contributors. All rights reserved.
+// License: Dual licensed as BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+//      or  GPL-2.0+ (http://opensource.org/licenses/gpl-license)
+//          with "runtime exception" (http://www.dune-project.org/license.html)
+
+#ifndef DUNE_XT_TEST_GRID_COUNTING_FUNCTORS_HH
+#define DUNE_XT_TEST_GRID_COUNTING_FUNCTORS_HH
+
+#include <array>
+
+#include <dune/xt/grid/walker/functors.hh>
+
+namespace Dune {
+namespace XT {
+namespace Grid {
+namespace Test {
+
+
+/**
+ * \brief Base of functors which count something in apply_local, for any of the functor interfaces of the Walker.
+ *
+ * Implements copy() (returning an empty Derived) and join() (summing the counts of the thread local copies), derived
+ * classes only increase counter(ii) in apply_local and may extend join() for additional state.
+ */
+template <class FunctorInterface, class Derived, size_t num_counts = 1>
+class CountingFunctorBase : public FunctorInterface
+{
+public:
+  FunctorInterface* copy() override
+  {
+    return new Derived();
+  }
+
+  void join(FunctorInterface& other) override
+  {
+    const auto& other_counts = dynamic_cast<CountingFunctorBase&>(other).counts_;
+    for (size_t ii = 0; ii < num_counts; ++ii)
+      counts_[ii] += other_counts[ii];
+  }
+
+  size_t count(const size_t ii = 0) const
+  {
+    return counts_[ii];
+  }
+
+protected:
+  size_t& counter(const size_t ii = 0)
+  {
+    return counts_[ii];
+  }
+
+private:
+  std::array<size_t, num_counts> counts_ = {};
+}; // class CountingFunctorBase
+
+
+//! Counts elements and intersections, \sa CountingFunctorBase
+template <class GridLayerType>
+class CountingFunctor
+    : public CountingFunctorBase<Functor::Codim0And1<GridLayerType>, CountingFunctor<GridLayerType>, 2>
+{
+  typedef Functor::Codim0And1<GridLayerType> InterfaceType;
+
+public:
+  using typename InterfaceType::EntityType;
+  using typename InterfaceType::IntersectionType;
+
+  void apply_local(const EntityType&) override final
+  {
+    ++this->counter(0);
+  }
+
+  void apply_local(const IntersectionType&, const EntityType&, const EntityType&) override final
+  {
+    ++this->counter(1);
+  }
+
+  size_t elements() const
+  {
+    return this->count(0);
+  }
+
+  size_t intersections() const
+  {
+    return this->count(1);
+  }
+}; // class CountingFunctor
+
+
+} // namespace Test
+} // namespace Grid
+} // namespace XT
+} // namespace Dune
+
+#endif // DUNE_XT_TEST_GRID_COUNTING_FUNCTORS_HH
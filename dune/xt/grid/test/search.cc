@@ -15,6 +15,10 @@
 #include <dune/xt/grid/grids.hh>
 #include <dune/xt/grid/information.hh>
 #include <dune/xt/grid/search.hh>
+#include <dune/xt/grid/search/bounding-box.hh>
+#include <dune/xt/grid/search/neighbor-walk.hh>
+#include <dune/xt/grid/search/parallel.hh>
+#include <dune/xt/grid/search/structured.hh>
 #include <dune/xt/grid/view/periodic.hh>
 
 struct InLevelSearch : public testing::Test
@@ -41,6 +45,157 @@ struct InLevelSearch : public testing::Test
     EXPECT_GE(periodic_result.size(), 1);
   }
 
+  void check_bounding_box()
+  {
+    const auto view = grid_provider_.leaf_view();
+    const auto& index_set = view.indexSet();
+    const auto dimensions = Dune::XT::Grid::dimensions(view);
+    const auto search = Dune::XT::Grid::make_entity_bounding_box_search(view);
+    typedef std::remove_const<decltype(dimensions.view_center())>::type PointType;
+    std::vector<PointType> points{dimensions.view_center()};
+    for (auto&& element : elements(view)) {
+      points.emplace_back(element.geometry().center());
+      points.emplace_back(element.geometry().corner(0));
+    }
+    Dune::XT::Grid::EntityInlevelSearch<decltype(view)> inlevel_search(view);
+    const auto result = search(points);
+    const auto inlevel_result = inlevel_search(points);
+    ASSERT_EQ(result.size(), points.size());
+    for (size_t ii = 0; ii < points.size(); ++ii) {
+      ASSERT_TRUE(result[ii] != nullptr);
+      ASSERT_TRUE(inlevel_result[ii] != nullptr);
+      EXPECT_TRUE(Dune::XT::Grid::CheckInside<0>::check(result[ii]->geometry(), points[ii]));
+      // element centers are contained in a single element
+      if (ii % 2 == 1)
+        EXPECT_EQ(index_set.index(*result[ii]), index_set.index(*inlevel_result[ii]));
+    }
+    PointType outside = dimensions.view_center();
+    outside[0] = 2 * dimensions.coord_limits[0].max() + 1;
+    EXPECT_TRUE(search.find(outside) == nullptr);
+  }
+
+  //! uses EntityStructuredSearch for the YaspGrids, EntityBoundingBoxSearch otherwise
+  void check_entity_search()
+  {
+    const auto view = grid_provider_.leaf_view();
+    const auto periodic_view = Dune::XT::Grid::make_periodic_grid_layer(view);
+    const auto& index_set = view.indexSet();
+    const auto dimensions = Dune::XT::Grid::dimensions(view);
+    const auto search = Dune::XT::Grid::make_entity_search(view);
+    const auto periodic_search = Dune::XT::Grid::make_entity_search(periodic_view);
+    typedef std::remove_const<decltype(dimensions.view_center())>::type PointType;
+    for (auto&& element : elements(view)) {
+      const PointType center = element.geometry().center();
+      const auto result = search.find(center);
+      ASSERT_TRUE(result != nullptr);
+      EXPECT_EQ(index_set.index(element), index_set.index(*result));
+      const auto periodic_result = periodic_search.find(center);
+      ASSERT_TRUE(periodic_result != nullptr);
+      EXPECT_EQ(index_set.index(element), index_set.index(*periodic_result));
+    }
+    const auto result = search(std::vector<PointType>{dimensions.view_center()});
+    ASSERT_EQ(result.size(), 1);
+    ASSERT_TRUE(result[0] != nullptr);
+    EXPECT_TRUE(Dune::XT::Grid::CheckInside<0>::check(result[0]->geometry(), dimensions.view_center()));
+    PointType outside = dimensions.view_center();
+    outside[0] = 2 * dimensions.coord_limits[0].max() + 1;
+    EXPECT_TRUE(search.find(outside) == nullptr);
+  }
+
+  void check_parallel()
+  {
+    const auto view = grid_provider_.leaf_view();
+    const auto& index_set = view.indexSet();
+    typedef std::remove_const<decltype(Dune::XT::Grid::dimensions(view).view_center())>::type PointType;
+    std::vector<PointType> points;
+    std::vector<size_t> indices;
+    for (size_t rr = 0; rr < 10; ++rr)
+      for (auto&& element : elements(view)) {
+        points.emplace_back(element.geometry().center());
+        indices.emplace_back(index_set.index(element));
+      }
+    const auto bounding_box_search = Dune::XT::Grid::make_entity_bounding_box_search(view);
+    const auto search = Dune::XT::Grid::make_entity_search(view);
+    for (const bool use_tbb : {false, true}) {
+      decltype(search)::EntityVectorType results(points.size());
+      decltype(bounding_box_search)::EntityVectorType bounding_box_results(points.size());
+      Dune::XT::Grid::find_entities(search, points, results, use_tbb);
+      Dune::XT::Grid::find_entities(bounding_box_search, points, bounding_box_results, use_tbb);
+      for (size_t ii = 0; ii < points.size(); ++ii) {
+        ASSERT_TRUE(results[ii] != nullptr);
+        ASSERT_TRUE(bounding_box_results[ii] != nullptr);
+        EXPECT_EQ(indices[ii], index_set.index(*results[ii]));
+        EXPECT_EQ(indices[ii], index_set.index(*bounding_box_results[ii]));
+      }
+    }
+    decltype(search)::EntityVectorType too_few_results(1);
+    EXPECT_THROW(Dune::XT::Grid::find_entities(search, points, too_few_results),
+                 Dune::XT::Common::Exceptions::shapes_do_not_match);
+  }
+
+  template <class SearchType>
+  void check_locate(const SearchType& search)
+  {
+    const auto view = grid_provider_.leaf_view();
+    const auto& index_set = view.indexSet();
+    typedef std::remove_const<decltype(Dune::XT::Grid::dimensions(view).view_center())>::type PointType;
+    std::vector<PointType> points;
+    for (auto&& element : elements(view))
+      points.emplace_back(element.geometry().center());
+    std::vector<typename SearchType::ResultType> results(points.size());
+    Dune::XT::Grid::locate_entities(search, points, results);
+    const auto serial_results = search.locate(points);
+    ASSERT_EQ(serial_results.size(), points.size());
+    size_t ii = 0;
+    for (auto&& element : elements(view)) {
+      for (const auto& result : {results[ii], serial_results[ii]}) {
+        ASSERT_TRUE(result.found);
+        EXPECT_EQ(index_set.index(element), result.index);
+        EXPECT_TRUE(view.grid().entity(result.seed) == element);
+        const PointType global = element.geometry().global(result.local);
+        EXPECT_TRUE(Dune::XT::Common::FloatCmp::eq(global, points[ii]));
+      }
+      ++ii;
+    }
+    // a miss does not keep anything of an earlier hit
+    const auto dimensions = Dune::XT::Grid::dimensions(view);
+    PointType outside = dimensions.view_center();
+    outside[0] = 2 * dimensions.coord_limits[0].max() + 1;
+    auto result = results.back();
+    EXPECT_FALSE(search.locate(outside, result));
+    EXPECT_EQ(size_t(0), result.index);
+  }
+
+  void check_neighbor_walk()
+  {
+    const auto view = grid_provider_.leaf_view();
+    const auto& index_set = view.indexSet();
+    const auto dimensions = Dune::XT::Grid::dimensions(view);
+    const auto search = Dune::XT::Grid::make_entity_neighbor_walk_search(view);
+    typedef std::remove_const<decltype(dimensions.view_center())>::type PointType;
+    const auto first_element = *view.begin<0>();
+    decltype(search)::ResultType result;
+    for (auto&& element : elements(view)) {
+      // from the first element to all others
+      const PointType center = element.geometry().center();
+      ASSERT_TRUE(search.locate(center, first_element, result));
+      EXPECT_EQ(index_set.index(element), result.index);
+      const PointType global = element.geometry().global(result.local);
+      EXPECT_TRUE(Dune::XT::Common::FloatCmp::eq(global, center));
+      // from all elements to the center
+      const auto found = search.find(dimensions.view_center(), element);
+      ASSERT_TRUE(found != nullptr);
+      EXPECT_TRUE(Dune::XT::Grid::CheckInside<0>::check(found->geometry(), dimensions.view_center()));
+    }
+    // continue at the last result, fall back to the global search for points outside of the domain
+    ASSERT_TRUE(search.locate(dimensions.view_center(), result));
+    EXPECT_TRUE(Dune::XT::Grid::CheckInside<0>::check(Dune::XT::Grid::entity_from_seed(view, result.seed).geometry(),
+                                                      dimensions.view_center()));
+    PointType outside = dimensions.view_center();
+    outside[0] = 2 * dimensions.coord_limits[0].max() + 1;
+    EXPECT_FALSE(search.locate(outside, first_element, result));
+  }
+
   GridProviderType grid_provider_;
 }; // class ConstGridProviderBase
 
@@ -49,3 +204,30 @@ TEST_F(InLevelSearch, check)
 {
   this->check();
 }
+
+TEST_F(InLevelSearch, bounding_box)
+{
+  this->check_bounding_box();
+}
+
+TEST_F(InLevelSearch, entity_search)
+{
+  this->check_entity_search();
+}
+
+TEST_F(InLevelSearch, parallel)
+{
+  this->check_parallel();
+}
+
+TEST_F(InLevelSearch, locate)
+{
+  const auto view = this->grid_provider_.leaf_view();
+  this->check_locate(Dune::XT::Grid::make_entity_bounding_box_search(view));
+  this->check_locate(Dune::XT::Grid::make_entity_search(view));
+}
+
+TEST_F(InLevelSearch, neighbor_walk)
+{
+  this->check_neighbor_walk();
+}
@@ -11,6 +11,13 @@
 
 #include <dune/xt/common/test/main.hxx>
 
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <numeric>
+#include <set>
+#include <thread>
+
 #if DUNE_VERSION_NEWER(DUNE_COMMON, 3, 9) && HAVE_TBB // EXADUNE
 #include <dune/grid/utility/partitioning/seedlist.hh>
 #endif
@@ -19,22 +26,152 @@
 #include <dune/xt/common/parallel/partitioner.hh>
 
 #include <dune/xt/grid/gridprovider/cube.hh>
+#include <dune/xt/grid/grids.hh>
+#include <dune/xt/grid/information.hh>
+#include <dune/xt/grid/parallel/partitioning/space-filling-curve.hh>
+#include <dune/xt/grid/view/periodic.hh>
 #include <dune/xt/grid/walker.hh>
 
+#include <dune/xt/grid/test/counting_functors.hh>
 
 using namespace Dune::XT::Common;
 using namespace Dune::XT::Grid;
 using namespace std;
 
-typedef testing::Types<Int<1>, Int<2>, Int<3>> GridDims;
+
+//! counts father-child pairs, thread local copies are merged on join
+template <class GL>
+struct FatherChildCountingFunctor
+    : public Dune::XT::Grid::Test::CountingFunctorBase<Functor::FatherChild<GL>, FatherChildCountingFunctor<GL>, 2>
+{
+  using EntityType = extract_entity_t<GL>;
+
+  void apply_local(const EntityType& father, const EntityType& child) override final
+  {
+    ++this->counter(0);
+    if (father.level() + 1 != child.level() || !(child.father() == father))
+      ++this->counter(1);
+  }
+
+  size_t pairs() const
+  {
+    return this->count(0);
+  }
+
+  size_t wrong_pairs() const
+  {
+    return this->count(1);
+  }
+};
+
+/**
+ * Walks the hierarchy below the coarsest level of grid in both orders, serially and in parallel, and checks that each
+ * father-child pair is visited once and that fathers and children are visited in the right order.
+ */
+template <class GridType>
+void walk_hierarchy_and_check(const GridType& grid)
+{
+  typedef typename GridType::LevelGridView LevelGridViewType;
+  using EntityType = extract_entity_t<LevelGridViewType>;
+  const int max_level = grid.maxLevel();
+  // indexed by the level index sets, the elements may have different numbers of children
+  vector<vector<size_t>> num_children(max_level + 1);
+  size_t num_pairs = 0;
+  for (int lvl = 0; lvl <= max_level; ++lvl) {
+    const auto level_view = grid.levelGridView(lvl);
+    num_children[lvl].assign(level_view.size(0), 0);
+    if (lvl > 0)
+      num_pairs += level_view.size(0);
+    if (lvl == max_level)
+      continue;
+    for (auto&& element : elements(level_view))
+      for (auto&& child : descendantElements(element, lvl + 1)) {
+        DUNE_UNUSED_PARAMETER(child);
+        ++num_children[lvl][level_view.indexSet().index(element)];
+      }
+  }
+  for (const bool use_tbb : {false, true}) {
+    for (const bool fine_to_coarse : {false, true}) {
+      FatherChildCountingFunctor<LevelGridViewType> counter;
+      // each subtree is walked by one thread
+      vector<vector<size_t>> visited_children(max_level + 1);
+      vector<vector<unsigned char>> visited_as_child(max_level + 1);
+      for (int lvl = 0; lvl <= max_level; ++lvl) {
+        visited_children[lvl].assign(num_children[lvl].size(), 0);
+        visited_as_child[lvl].assign(num_children[lvl].size(), 0);
+      }
+      atomic<size_t> wrong_order(0);
+      HierarchicWalker<LevelGridViewType> walker(grid.levelGridView(0));
+      walker.append(counter);
+      walker.append([&](const EntityType& father, const EntityType& child) {
+        const size_t father_index = grid.levelIndexSet(father.level()).index(father);
+        const size_t child_index = grid.levelIndexSet(child.level()).index(child);
+        if (fine_to_coarse && visited_children[child.level()][child_index] != num_children[child.level()][child_index])
+          wrong_order++;
+        if (!fine_to_coarse && father.level() > 0 && !visited_as_child[father.level()][father_index])
+          wrong_order++;
+        visited_children[father.level()][father_index]++;
+        visited_as_child[child.level()][child_index] = 1;
+      });
+      if (fine_to_coarse)
+        walker.walk_fine_to_coarse(use_tbb);
+      else
+        walker.walk(use_tbb);
+      EXPECT_EQ(num_pairs, counter.pairs());
+      EXPECT_EQ(size_t(0), counter.wrong_pairs());
+      EXPECT_EQ(size_t(0), wrong_order);
+    }
+  }
+} // ... walk_hierarchy_and_check(...)
+
+
+//! walks on the leaf view of G
+template <class G>
+struct LeafViewWalk
+{
+  typedef G GridType;
+  typedef typename GridType::LeafGridView GridLayerType;
+
+  static GridLayerType grid_layer(const GridType& grid)
+  {
+    return grid.leafGridView();
+  }
+};
+
+/**
+ * Walks on a PeriodicGridLayer without periodic directions around the leaf view of G, i.e. on the same elements as
+ * LeafViewWalk, but through a grid layer with its own index set and intersection iterator. It takes the place of a grid
+ * part, which are not available in dune-xt-grid.
+ */
+template <class G>
+struct PeriodicLayerWalk
+{
+  typedef G GridType;
+  typedef PeriodicGridLayer<typename GridType::LeafGridView, true> GridLayerType;
+
+  static GridLayerType grid_layer(const GridType& grid)
+  {
+    return make_periodic_grid_layer<true>(grid.leafGridView(), std::bitset<GridType::dimension>());
+  }
+};
+
+// clang-format off
+typedef testing::Types<LeafViewWalk<YASP_1D_EQUIDISTANT_OFFSET>,
+                       LeafViewWalk<YASP_2D_EQUIDISTANT_OFFSET>,
+                       LeafViewWalk<YASP_3D_EQUIDISTANT_OFFSET>,
+                       PeriodicLayerWalk<YASP_2D_EQUIDISTANT_OFFSET>
+#if HAVE_DUNE_ALUGRID
+                       , LeafViewWalk<ALU_2D_SIMPLEX_CONFORMING>
+#endif
+                       > WalkedGridLayers; // clang-format on
 
 template <class T>
 struct GridWalkerTest : public ::testing::Test
 {
-  static const size_t griddim = T::value;
+  typedef typename T::GridType GridType;
+  typedef typename T::GridLayerType GridLayerType;
+  static const size_t griddim = GridType::dimension;
   static const size_t level = 4;
-  typedef Dune::YaspGrid<griddim, Dune::EquidistantOffsetCoordinates<double, griddim>> GridType;
-  typedef typename GridType::LeafGridView GridLayerType;
   using EntityType = extract_entity_t<GridLayerType>;
   using IntersectionType = extract_intersection_t<GridLayerType>;
   const GridProvider<GridType, none_t> grid_prv;
@@ -43,9 +180,14 @@ struct GridWalkerTest : public ::testing::Test
   {
   }
 
+  GridLayerType grid_layer() const
+  {
+    return T::grid_layer(grid_prv.grid());
+  }
+
   void check_count()
   {
-    const auto gv = grid_prv.grid().leafGridView();
+    const auto gv = grid_layer();
     Walker<GridLayerType> walker(gv);
     const auto correct_size = gv.size(0);
     atomic<size_t> count(0);
@@ -79,9 +221,431 @@ struct GridWalkerTest : public ::testing::Test
     }
   }
 
+  typedef Dune::XT::Grid::Test::CountingFunctor<GridLayerType> CountingFunctor;
+
+  struct VolumeReduction : public Functor::Codim0Reduction<GridLayerType>
+  {
+    typedef Functor::Codim0Reduction<GridLayerType> BaseType;
+    using BaseType::BaseType;
+
+    double compute_locally(const EntityType& entity) override final
+    {
+      return entity.geometry().volume();
+    }
+
+    Functor::Codim0<GridLayerType>* copy() override final
+    {
+      return new VolumeReduction(*this);
+    }
+  };
+
+  //! counts the sub-entities of codimension cd, thread local copies are merged on join
+  template <size_t cd>
+  struct SubEntityCountingFunctor
+      : public Dune::XT::Grid::Test::CountingFunctorBase<Functor::CodimN<GridLayerType, cd>,
+                                                         SubEntityCountingFunctor<cd>>
+  {
+    void apply_local(const extract_entity_t<GridLayerType, cd>&, const EntityType&, const size_t) override final
+    {
+      ++this->counter();
+    }
+  };
+
+  void check_codim_n()
+  {
+    const auto gv = grid_layer();
+    for (const bool use_tbb : {false, true}) {
+      Walker<GridLayerType> walker(gv);
+      SubEntityCountingFunctor<griddim> vertices;
+      SubEntityCountingFunctor<griddim - 1> edges;
+      walker.append(vertices).append(edges);
+      walker.walk(use_tbb);
+      EXPECT_EQ(size_t(gv.size(griddim)), vertices.count());
+      EXPECT_EQ(size_t(gv.size(griddim - 1)), edges.count());
+    }
+  }
+
+  //! sums the volumes of the elements and compares them to their integration elements, using all lanes of each batch
+  struct BatchVolumeFunctor
+      : public Dune::XT::Grid::Test::CountingFunctorBase<Functor::Codim0Batch<GridLayerType, 4>, BatchVolumeFunctor>
+  {
+    typedef Dune::XT::Grid::Test::CountingFunctorBase<Functor::Codim0Batch<GridLayerType, 4>, BatchVolumeFunctor>
+        BaseType;
+    typedef ElementBatch<GridLayerType, 4> BatchType;
+
+    void apply_local(const BatchType& batch) override final
+    {
+      // all elements of the test grids are of the same type
+      const double reference_volume = reference_element(batch.element(0).geometry()).volume();
+      typename BatchType::LaneType difference;
+      for (size_t ll = 0; ll < BatchType::lanes; ++ll)
+        difference[ll] = batch.volumes()[ll] - reference_volume * batch.integration_elements()[ll];
+      for (size_t ll = 0; ll < batch.size(); ++ll) {
+        volume += batch.volumes()[ll];
+        max_difference = std::max(max_difference, std::abs(difference[ll]));
+      }
+      this->counter() += batch.size();
+    }
+
+    void join(Functor::Codim0Batch<GridLayerType, 4>& other) override final
+    {
+      BaseType::join(other);
+      auto& other_functor = dynamic_cast<BatchVolumeFunctor&>(other);
+      volume += other_functor.volume;
+      max_difference = std::max(max_difference, other_functor.max_difference);
+    }
+
+    double volume = 0;
+    double max_difference = 0;
+  };
+
+  void check_batches()
+  {
+    const auto gv = grid_layer();
+    for (const bool use_tbb : {false, true}) {
+      BatchVolumeFunctor functor;
+      Walker<GridLayerType> walker(gv);
+      walker.append(functor);
+      walker.walk(use_tbb);
+      EXPECT_EQ(size_t(gv.size(0)), functor.count());
+      EXPECT_DOUBLE_EQ(1., functor.volume);
+      EXPECT_NEAR(0., functor.max_difference, 1e-15);
+    }
+  }
+
+  void check_geometry_cache()
+  {
+    const auto gv = grid_layer();
+    Walker<GridLayerType> walker(gv);
+    walker.use_geometry_cache();
+    const auto cache = walker.geometry_cache();
+    ASSERT_TRUE(cache->valid());
+    cache->invalidate();
+    EXPECT_FALSE(cache->valid());
+    walker.append([&](const EntityType& element) {
+      const auto geometry = element.geometry();
+      EXPECT_DOUBLE_EQ(geometry.volume(), cache->volume(element));
+      EXPECT_DOUBLE_EQ(entity_diameter(element), cache->diameter(element));
+      const auto& local_center = reference_element(geometry).position(0, 0);
+      EXPECT_DOUBLE_EQ(geometry.integrationElement(local_center), cache->integration_element(element));
+      EXPECT_DOUBLE_EQ(0., (geometry.center() - cache->center(element)).two_norm());
+      EXPECT_DOUBLE_EQ(geometry.jacobianInverseTransposed(local_center)[0][0],
+                       cache->jacobian_inverse_transposed(element)[0][0]);
+    });
+    walker.walk();
+    EXPECT_TRUE(cache->valid());
+    // adaptation is detected
+    auto grid_provider = make_cube_grid<GridType>(0., 1., 2);
+    GeometryCache<typename GridType::LeafGridView> adapted_cache(grid_provider.leaf_view());
+    grid_provider.global_refine(1);
+    EXPECT_FALSE(adapted_cache.valid());
+  }
+
+  void check_reduction()
+  {
+    const auto gv = grid_layer();
+    std::vector<double> deterministic_results;
+    for (const bool use_tbb : {false, true}) {
+      Walker<GridLayerType> walker(gv);
+      VolumeReduction volume;
+      VolumeReduction deterministic_volume(gv, true);
+      walker.append(volume);
+      walker.append(deterministic_volume);
+      walker.walk(use_tbb);
+      EXPECT_DOUBLE_EQ(1., volume.result());
+      EXPECT_DOUBLE_EQ(1., deterministic_volume.result());
+      deterministic_results.push_back(deterministic_volume.result());
+    }
+    EXPECT_EQ(deterministic_results[0], deterministic_results[1]);
+  }
+
+  //! counts the joined copies which did not apply both parts of the functor, \sa Walker::copy
+  struct PairedCountingFunctor
+      : public Dune::XT::Grid::Test::CountingFunctorBase<Functor::Codim0And1<GridLayerType>, PairedCountingFunctor, 3>
+  {
+    typedef Dune::XT::Grid::Test::CountingFunctorBase<Functor::Codim0And1<GridLayerType>, PairedCountingFunctor, 3>
+        BaseType;
+
+    void apply_local(const EntityType&) override final
+    {
+      ++this->counter(0);
+    }
+
+    void apply_local(const IntersectionType&, const EntityType&, const EntityType&) override final
+    {
+      ++this->counter(1);
+    }
+
+    void join(Functor::Codim0And1<GridLayerType>& other) override final
+    {
+      const auto& other_functor = dynamic_cast<const PairedCountingFunctor&>(other);
+      if ((other_functor.count(0) == 0) != (other_functor.count(1) == 0))
+        ++this->counter(2);
+      BaseType::join(other);
+    }
+  };
+
+  void check_thread_local_copies()
+  {
+    const auto gv = grid_layer();
+    const Statistics statistics(gv);
+    for (const bool use_tbb : {false, true}) {
+      Walker<GridLayerType> walker(gv);
+      CountingFunctor counter;
+      PairedCountingFunctor paired_counter;
+      Walker<GridLayerType> nested_walker(gv);
+      PairedCountingFunctor nested_paired_counter;
+      nested_walker.append(nested_paired_counter);
+      walker.append(counter).append(paired_counter).append(nested_walker);
+      walker.walk(use_tbb);
+      EXPECT_EQ(size_t(gv.size(0)), counter.elements());
+      EXPECT_EQ(statistics.numberOfIntersections, counter.intersections());
+      // a single copy of a Functor::Codim0And1 applies both of its parts
+      for (const auto& paired : {&paired_counter, &nested_paired_counter}) {
+        EXPECT_EQ(size_t(gv.size(0)), paired->count(0));
+        EXPECT_EQ(statistics.numberOfIntersections, paired->count(1));
+        EXPECT_EQ(size_t(0), paired->count(2));
+      }
+    }
+  }
+
+  void check_inner_intersections_once()
+  {
+    const auto gv = grid_layer();
+    const Statistics statistics(gv);
+    const auto inner_intersections = statistics.numberOfInnerIntersections;
+    const auto boundary_intersections = statistics.numberOfBoundaryIntersections;
+    for (const bool use_tbb : {false, true}) {
+      Walker<GridLayerType> walker(gv);
+      Walker<GridLayerType> nested_walker(gv);
+      atomic<size_t> primally_count(0), nested_count(0), all_count(0);
+      walker.append([&](const IntersectionType&, const EntityType&, const EntityType&) { primally_count++; },
+                    new ApplyOn::InnerIntersectionsPrimally<GridLayerType>());
+      nested_walker.append([&](const IntersectionType&, const EntityType&, const EntityType&) { nested_count++; },
+                           new ApplyOn::InnerIntersectionsPrimally<GridLayerType>());
+      walker.append(nested_walker);
+      walker.visit_inner_intersections_once();
+      walker.walk(use_tbb);
+      EXPECT_EQ(inner_intersections / 2, primally_count);
+      EXPECT_EQ(inner_intersections / 2, nested_count);
+      // functors which would miss one side of an inner intersection are rejected
+      walker.visit_inner_intersections_once();
+      EXPECT_THROW(walker.append([&](const IntersectionType&, const EntityType&, const EntityType&) { all_count++; }),
+                   Dune::XT::Common::Exceptions::you_are_using_this_wrong);
+      EXPECT_THROW(walker.append_indexed([&](const Functor::IntersectionIndices&) { all_count++; }),
+                   Dune::XT::Common::Exceptions::you_are_using_this_wrong);
+      walker.visit_inner_intersections_once(false);
+      walker.append([&](const IntersectionType&, const EntityType&, const EntityType&) { all_count++; },
+                    new ApplyOn::BoundaryIntersections<GridLayerType>());
+      EXPECT_THROW(walker.visit_inner_intersections_once(), Dune::XT::Common::Exceptions::you_are_using_this_wrong);
+      walker.walk(use_tbb);
+      EXPECT_EQ(boundary_intersections, all_count);
+    }
+  }
+
+  void check_walk_plan()
+  {
+    const auto gv = grid_layer();
+    const Statistics statistics(gv);
+    auto plan = std::make_shared<WalkPlan<GridLayerType>>(gv);
+    EXPECT_TRUE(plan->valid());
+    EXPECT_EQ(size_t(gv.size(0)), plan->size());
+    for (const bool use_tbb : {false, true}) {
+      Walker<GridLayerType> walker(gv);
+      walker.use_walk_plan(plan);
+      CountingFunctor counter;
+      atomic<size_t> correct_neighbors(0);
+      walker.append(counter);
+      walker.append([&](const IntersectionType& intersection, const EntityType& inside, const EntityType& outside) {
+        if (intersection.neighbor() && intersection.inside() == inside && intersection.outside() == outside)
+          correct_neighbors++;
+      });
+      walker.walk(use_tbb);
+      EXPECT_EQ(size_t(gv.size(0)), counter.elements());
+      EXPECT_EQ(statistics.numberOfIntersections, counter.intersections());
+      EXPECT_EQ(statistics.numberOfInnerIntersections, correct_neighbors);
+    }
+    // only lambdas on indices, the arrays of the plan are replayed alone, in once-mode the intersections are filtered
+    for (const bool once : {false, true}) {
+      for (const bool use_tbb : {false, true}) {
+        atomic<size_t> element_count(0), intersection_count(0), wrong_indices(0);
+        Walker<GridLayerType> walker(gv);
+        walker.use_walk_plan(plan).visit_inner_intersections_once(once);
+        walker.append_indexed([&](const size_t index) {
+          element_count++;
+          if (index >= size_t(gv.size(0)))
+            wrong_indices++;
+        });
+        const auto count_intersection = [&](const Functor::IntersectionIndices& indices) {
+          intersection_count++;
+          if ((indices.index_in_outside < 0) != (indices.outside == indices.inside))
+            wrong_indices++;
+        };
+        if (once)
+          walker.append_indexed([&](const IntersectionType&,
+                                    const Functor::IntersectionIndices& indices) { count_intersection(indices); },
+                                new ApplyOn::InnerIntersectionsPrimally<GridLayerType>());
+        else
+          walker.append_indexed(count_intersection);
+        walker.walk(use_tbb);
+        EXPECT_EQ(size_t(gv.size(0)), element_count);
+        EXPECT_EQ(once ? statistics.numberOfInnerIntersections / 2 : statistics.numberOfIntersections,
+                  intersection_count);
+        EXPECT_EQ(size_t(0), wrong_indices);
+      }
+    }
+    // adaptation is detected
+    auto grid_provider = make_cube_grid<GridType>(0., 1., 2);
+    WalkPlan<typename GridType::LeafGridView> adapted_plan(grid_provider.leaf_view());
+    grid_provider.global_refine(1);
+    EXPECT_FALSE(adapted_plan.valid());
+    adapted_plan.update();
+    EXPECT_TRUE(adapted_plan.valid());
+  }
+
+  void check_indexed_lambdas()
+  {
+    const auto gv = grid_layer();
+    const auto& index_set = gv.indexSet();
+    const Statistics statistics(gv);
+    for (const bool use_plan : {false, true}) {
+      for (const bool use_tbb : {false, true}) {
+        atomic<size_t> element_count(0), intersection_count(0), wrong_indices(0);
+        Walker<GridLayerType> walker(gv);
+        walker.use_walk_plan(use_plan);
+        walker.append_indexed([&](const EntityType& element, const size_t index) {
+          element_count++;
+          if (index != size_t(index_set.index(element)))
+            wrong_indices++;
+        });
+        walker.append_indexed([&](const IntersectionType& intersection, const Functor::IntersectionIndices& indices) {
+          intersection_count++;
+          if (indices.inside != size_t(index_set.index(intersection.inside()))
+              || indices.index_in_inside != int(intersection.indexInInside()))
+            wrong_indices++;
+          if (intersection.neighbor()
+              && (indices.outside != size_t(index_set.index(intersection.outside()))
+                  || indices.index_in_outside != int(intersection.indexInOutside())))
+            wrong_indices++;
+          if (!intersection.neighbor() && (indices.outside != indices.inside || indices.index_in_outside != -1))
+            wrong_indices++;
+        });
+        walker.walk(use_tbb);
+        EXPECT_EQ(size_t(gv.size(0)), element_count);
+        EXPECT_EQ(statistics.numberOfIntersections, intersection_count);
+        EXPECT_EQ(size_t(0), wrong_indices);
+      }
+    }
+  }
+
+  void check_hierarchic_walk()
+  {
+    auto grid_provider = make_cube_grid<GridType>(0., 1., 2);
+    grid_provider.global_refine(2);
+    walk_hierarchy_and_check(grid_provider.grid());
+  }
+
+  void check_static_walker()
+  {
+    const auto gv = grid_layer();
+    const Statistics statistics(gv);
+    for (const bool use_tbb : {false, true}) {
+      CountingFunctor counter;
+      atomic<size_t> element_count(0), boundary_count(0);
+      auto walker = make_static_walker(
+          gv,
+          counter,
+          [&](const EntityType&) { element_count++; },
+          static_apply_on<GridLayerType>(
+              [&](const IntersectionType&, const EntityType&, const EntityType&) { boundary_count++; },
+              ApplyOn::AllEntities<GridLayerType>(),
+              ApplyOn::BoundaryIntersections<GridLayerType>()));
+      walker.walk(use_tbb);
+      EXPECT_EQ(size_t(gv.size(0)), counter.elements());
+      EXPECT_EQ(statistics.numberOfIntersections, counter.intersections());
+      EXPECT_EQ(size_t(gv.size(0)), element_count);
+      EXPECT_EQ(statistics.numberOfBoundaryIntersections, boundary_count);
+    }
+    // functors given by a reference to a base class which is not final are called virtually
+    struct ElementCounter : public Functor::Codim0<GridLayerType>
+    {
+      void apply_local(const EntityType&) override
+      {
+        ++elements;
+      }
+
+      size_t elements = 0;
+    };
+    struct DoubleElementCounter : public ElementCounter
+    {
+      void apply_local(const EntityType&) override
+      {
+        this->elements += 2;
+      }
+    };
+    DoubleElementCounter double_counter;
+    ElementCounter& counter = double_counter;
+    make_static_walker(gv, counter).walk(false);
+    EXPECT_EQ(2 * size_t(gv.size(0)), double_counter.elements);
+  }
+
+  void check_colored_walk()
+  {
+    const auto gv = grid_layer();
+    const Statistics statistics(gv);
+    const ColoredPartitioning<GridLayerType> coloring(gv, 4);
+    // elements of the same color touch disjoint sets of vertices
+    for (size_t cc = 0; cc < coloring.colors(); ++cc) {
+      std::vector<size_t> touched(gv.indexSet().size(GridLayerType::dimension), 0);
+      for (auto&& element : coloring.color(cc).everything()) {
+        std::set<size_t> vertices;
+        for (size_t ii = 0; ii < element.subEntities(GridLayerType::dimension); ++ii)
+          vertices.insert(gv.indexSet().subIndex(element, ii, GridLayerType::dimension));
+        for (auto&& intersection : intersections(gv, element))
+          if (intersection.neighbor())
+            for (size_t ii = 0; ii < intersection.outside().subEntities(GridLayerType::dimension); ++ii)
+              vertices.insert(gv.indexSet().subIndex(intersection.outside(), ii, GridLayerType::dimension));
+        for (const auto& vertex : vertices)
+          EXPECT_EQ(size_t(1), ++touched[vertex]);
+      }
+    }
+    // scatter into the outside element without synchronization
+    std::vector<size_t> visits(gv.size(0), 0);
+    Walker<GridLayerType> walker(gv);
+    walker.append([&](const IntersectionType&, const EntityType&, const EntityType& outside) {
+      ++visits[gv.indexSet().index(outside)];
+    });
+    walker.walk_colored(coloring);
+    EXPECT_EQ(statistics.numberOfIntersections, std::accumulate(visits.begin(), visits.end(), size_t(0)));
+  }
+
+  void check_instrumentation()
+  {
+    const auto gv = grid_layer();
+    const Statistics statistics(gv);
+    for (const bool use_tbb : {false, true}) {
+      Walker<GridLayerType> walker(gv);
+      CountingFunctor counter;
+      walker.append(counter);
+      walker.append([](const IntersectionType&, const EntityType&, const EntityType&) {},
+                    new ApplyOn::BoundaryIntersections<GridLayerType>());
+      walker.instrument();
+      walker.walk(use_tbb);
+      const auto& walker_statistics = walker.statistics();
+      ASSERT_EQ(size_t(3), walker_statistics.functors.size());
+      EXPECT_EQ(size_t(gv.size(0)), walker_statistics.functors[0].calls);
+      EXPECT_EQ(statistics.numberOfIntersections, walker_statistics.functors[1].calls);
+      EXPECT_EQ(statistics.numberOfIntersections, walker_statistics.functors[2].evaluations);
+      EXPECT_EQ(statistics.numberOfBoundaryIntersections, walker_statistics.functors[2].calls);
+      EXPECT_EQ(statistics.numberOfIntersections - statistics.numberOfBoundaryIntersections,
+                walker_statistics.functors[2].rejections);
+      EXPECT_EQ(size_t(gv.size(0)), counter.elements());
+    }
+  }
+
   void check_apply_on()
   {
-    const auto gv = grid_prv.grid().leafGridView();
+    const auto gv = grid_layer();
     Walker<GridLayerType> walker(gv);
 
     size_t filter_count = 0, all_count = 0;
@@ -97,9 +661,148 @@ struct GridWalkerTest : public ::testing::Test
     EXPECT_EQ(filter_count, all_count);
   }
 
+  //! records the threads on which prepare and finalize are called
+  struct ThreadRecordingFunctor : public Functor::Codim0<GridLayerType>
+  {
+    void prepare() override final
+    {
+      prepare_thread = this_thread::get_id();
+    }
+
+    void apply_local(const EntityType&) override final
+    {
+      ++elements;
+    }
+
+    void finalize() override final
+    {
+      finalize_thread = this_thread::get_id();
+    }
+
+    thread::id prepare_thread;
+    thread::id finalize_thread;
+    atomic<size_t> elements{0};
+  };
+
+  void check_walk_async()
+  {
+    const auto gv = grid_layer();
+    for (const bool use_tbb : {false, true}) {
+      ThreadRecordingFunctor functor;
+      Walker<GridLayerType> walker(gv);
+      walker.append(functor);
+      auto walk = walker.walk_async(use_tbb);
+      EXPECT_EQ(this_thread::get_id(), functor.prepare_thread);
+      walk.wait();
+      EXPECT_EQ(this_thread::get_id(), functor.finalize_thread);
+      EXPECT_EQ(size_t(gv.size(0)), functor.elements);
+      // exceptions are propagated by wait
+      walker.append([](const EntityType&) { DUNE_THROW(Exceptions::internal_error, ""); });
+      auto failing_walk = walker.walk_async(use_tbb);
+      EXPECT_THROW(failing_walk.wait(), Exceptions::internal_error);
+    }
+  }
+
+  void check_overlapping_walk()
+  {
+    const auto gv = grid_layer();
+    const Statistics statistics(gv);
+    for (const bool use_tbb : {false, true}) {
+      ThreadRecordingFunctor functor;
+      CountingFunctor counter;
+      Walker<GridLayerType> walker(gv);
+      walker.append(functor);
+      walker.append(counter);
+      bool communicated = false;
+      walker.walk_overlapping([&] { communicated = true; }, use_tbb);
+      EXPECT_TRUE(communicated);
+      EXPECT_EQ(this_thread::get_id(), functor.finalize_thread);
+      EXPECT_EQ(size_t(gv.size(0)), functor.elements);
+      EXPECT_EQ(size_t(gv.size(0)), counter.elements());
+      EXPECT_EQ(statistics.numberOfIntersections, counter.intersections());
+      // exceptions of the communication are propagated after the traversal finished
+      walker.append([](const EntityType&) {});
+      EXPECT_THROW(walker.walk_overlapping([] { DUNE_THROW(Exceptions::internal_error, ""); }, use_tbb),
+                   Exceptions::internal_error);
+    }
+  }
+
+  void check_fused_walk()
+  {
+    const auto gv = grid_layer();
+    const Statistics statistics(gv);
+    for (const bool use_tbb : {false, true}) {
+      CountingFunctor counter;
+      atomic<size_t> entity_count(0), boundary_count(0);
+      Walker<GridLayerType> walker(gv);
+      Walker<GridLayerType> first(gv);
+      Walker<GridLayerType> second(gv);
+      Walker<GridLayerType> nested(gv);
+      walker.append(counter);
+      first.append([&](const EntityType&) { ++entity_count; });
+      second.append([&](const IntersectionType&, const EntityType&, const EntityType&) { ++boundary_count; },
+                    new ApplyOn::BoundaryIntersections<GridLayerType>());
+      second.append(nested);
+      EXPECT_THROW(walker.fuse(walker), Dune::XT::Common::Exceptions::you_are_using_this_wrong);
+      EXPECT_THROW(nested.fuse(second), Dune::XT::Common::Exceptions::you_are_using_this_wrong);
+      walker.fuse(first).fuse(second);
+      walker.walk(use_tbb);
+      EXPECT_EQ(size_t(gv.size(0)), counter.elements());
+      EXPECT_EQ(statistics.numberOfIntersections, counter.intersections());
+      EXPECT_EQ(size_t(gv.size(0)), entity_count);
+      EXPECT_EQ(statistics.numberOfBoundaryIntersections, boundary_count);
+      // the functors were taken over
+      first.walk(use_tbb);
+      EXPECT_EQ(size_t(gv.size(0)), entity_count);
+    }
+  }
+
+  void check_default_filters()
+  {
+    const auto gv = grid_layer();
+    const Statistics statistics(gv);
+    // the shared singletons must not be deleted by the walkers
+    for (size_t ii = 0; ii < 2; ++ii) {
+      size_t entity_count = 0, intersection_count = 0;
+      Walker<GridLayerType> walker(gv);
+      walker.append([&](const EntityType&) { ++entity_count; }, ApplyOn::all_entities<GridLayerType>());
+      walker.append([&](const IntersectionType&, const EntityType&, const EntityType&) { ++intersection_count; },
+                    ApplyOn::all_intersections<GridLayerType>());
+      walker.walk();
+      EXPECT_EQ(size_t(gv.size(0)), entity_count);
+      EXPECT_EQ(statistics.numberOfIntersections, intersection_count);
+    }
+  }
+
+  void check_filter_masks()
+  {
+    const auto gv = grid_layer();
+    const Statistics statistics(gv);
+    const ApplyOn::EntityMask<GridLayerType> boundary_entities(gv, ApplyOn::BoundaryEntities<GridLayerType>());
+    const ApplyOn::IntersectionMask<GridLayerType> boundary_intersections(
+        gv, ApplyOn::BoundaryIntersections<GridLayerType>());
+    const ApplyOn::IntersectionMask<GridLayerType> inner_intersections_primally(
+        gv, ApplyOn::InnerIntersectionsPrimally<GridLayerType>());
+    EXPECT_TRUE(inner_intersections_primally.selects_inner_intersections_once());
+    for (const bool use_tbb : {false, true}) {
+      atomic<size_t> entity_count(0), boundary_count(0), inner_count(0), expected_entity_count(0);
+      Walker<GridLayerType> walker(gv);
+      walker.append([&](const EntityType&) { ++entity_count; }, boundary_entities.copy());
+      walker.append([&](const EntityType& entity) { expected_entity_count += entity.hasBoundaryIntersections(); });
+      walker.append([&](const IntersectionType&, const EntityType&, const EntityType&) { ++boundary_count; },
+                    boundary_intersections.copy());
+      walker.append([&](const IntersectionType&, const EntityType&, const EntityType&) { ++inner_count; },
+                    inner_intersections_primally.copy());
+      walker.walk(use_tbb);
+      EXPECT_EQ(expected_entity_count, entity_count);
+      EXPECT_EQ(statistics.numberOfBoundaryIntersections, boundary_count);
+      EXPECT_EQ(statistics.numberOfInnerIntersections / 2, inner_count);
+    }
+  }
+
   void check_partitionsets()
   {
-    const auto gv = grid_prv.grid().leafGridView();
+    const auto gv = grid_layer();
     Walker<GridLayerType> walker(gv);
 
     size_t filter_count = 0, all_count = 0, inner_count = 0, inner_set_count = 0;
@@ -125,7 +828,7 @@ struct GridWalkerTest : public ::testing::Test
 
   void check_partitioning()
   {
-    const auto gv = grid_prv.grid().leafGridView();
+    const auto gv = grid_layer();
     Walker<GridLayerType> walker(gv);
 
     size_t all_count = 0, inner_count = 0;
@@ -140,12 +843,219 @@ struct GridWalkerTest : public ::testing::Test
     Dune::XT::Grid::RangedPartitioning<GridLayerType, 0, Dune::Interior_Partition> interior_part(gv, 1);
     Dune::XT::Grid::RangedPartitioning<GridLayerType, 0, Dune::All_Partition> all_part(gv, 1);
   }
+
+  void check_weighted_partitioning()
+  {
+    const auto gv = grid_layer();
+    const size_t num_elements = gv.size(0);
+    // the first elements are expensive
+    std::vector<double> costs(num_elements, 1.);
+    for (size_t ii = 0; ii < num_elements / 4; ++ii)
+      costs[ii] = 10.;
+    WeightedPartitioning<GridLayerType> partitioning(gv, 8, costs);
+    EXPECT_EQ(size_t(8), partitioning.partitions());
+    const double total_cost = partitioning.cost(0, partitioning.partitions());
+    std::vector<size_t> visits(num_elements, 0);
+    for (size_t pp = 0; pp < partitioning.partitions(); ++pp) {
+      EXPECT_LE(partitioning.cost(pp, pp + 1), total_cost / 8 + 10.);
+      for (auto&& element : partitioning.partition(pp))
+        ++visits[gv.indexSet().index(element)];
+    }
+    for (const auto& visit : visits)
+      EXPECT_EQ(size_t(1), visit);
+
+    Walker<GridLayerType> walker(gv);
+    atomic<size_t> count(0);
+    walker.append([&](const EntityType&) { count++; });
+    walker.walk(partitioning);
+    EXPECT_EQ(num_elements, count);
+  }
+
+  template <class ElementRange>
+  static double path_length(const ElementRange& element_range)
+  {
+    double length = 0;
+    bool first = true;
+    typename EntityType::Geometry::GlobalCoordinate last_center;
+    for (auto&& element : element_range) {
+      const auto center = element.geometry().center();
+      if (!first)
+        length += (center - last_center).two_norm();
+      last_center = center;
+      first = false;
+    }
+    return length;
+  }
+
+  void check_space_filling_curve_partitioning()
+  {
+    const auto gv = grid_layer();
+    const size_t num_elements = gv.size(0);
+    for (const auto curve : {SpaceFillingCurve::hilbert, SpaceFillingCurve::morton}) {
+      SpaceFillingCurvePartitioning<GridLayerType> partitioning(gv, 4, curve);
+      std::vector<size_t> visits(num_elements, 0);
+      for (auto&& element : partitioning.everything())
+        ++visits[gv.indexSet().index(element)];
+      for (const auto& visit : visits)
+        EXPECT_EQ(size_t(1), visit);
+      EXPECT_LE(path_length(partitioning.everything()), path_length(elements(gv)) + 1e-10);
+    }
+  }
 };
 
-TYPED_TEST_CASE(GridWalkerTest, GridDims);
-TYPED_TEST(GridWalkerTest, Misc)
+TYPED_TEST_CASE(GridWalkerTest, WalkedGridLayers);
+TYPED_TEST(GridWalkerTest, count)
 {
   this->check_count();
+}
+
+TYPED_TEST(GridWalkerTest, thread_local_copies)
+{
+  this->check_thread_local_copies();
+}
+
+TYPED_TEST(GridWalkerTest, reduction)
+{
+  this->check_reduction();
+}
+
+TYPED_TEST(GridWalkerTest, codim_n)
+{
+  this->check_codim_n();
+}
+
+TYPED_TEST(GridWalkerTest, batches)
+{
+  this->check_batches();
+}
+
+TYPED_TEST(GridWalkerTest, geometry_cache)
+{
+  this->check_geometry_cache();
+}
+
+TYPED_TEST(GridWalkerTest, inner_intersections_once)
+{
+  this->check_inner_intersections_once();
+}
+
+TYPED_TEST(GridWalkerTest, walk_plan)
+{
+  this->check_walk_plan();
+}
+
+TYPED_TEST(GridWalkerTest, indexed_lambdas)
+{
+  this->check_indexed_lambdas();
+}
+
+TYPED_TEST(GridWalkerTest, hierarchic_walk)
+{
+  this->check_hierarchic_walk();
+}
+
+TYPED_TEST(GridWalkerTest, static_walker)
+{
+  this->check_static_walker();
+}
+
+TYPED_TEST(GridWalkerTest, colored_walk)
+{
+  this->check_colored_walk();
+}
+
+TYPED_TEST(GridWalkerTest, instrumentation)
+{
+  this->check_instrumentation();
+}
+
+TYPED_TEST(GridWalkerTest, apply_on)
+{
   this->check_apply_on();
+}
+
+TYPED_TEST(GridWalkerTest, fused_walk)
+{
+  this->check_fused_walk();
+}
+
+TYPED_TEST(GridWalkerTest, walk_async)
+{
+  this->check_walk_async();
+}
+
+TYPED_TEST(GridWalkerTest, overlapping_walk)
+{
+  this->check_overlapping_walk();
+}
+
+TYPED_TEST(GridWalkerTest, default_filters)
+{
+  this->check_default_filters();
+}
+
+TYPED_TEST(GridWalkerTest, filter_masks)
+{
+  this->check_filter_masks();
+}
+
+TYPED_TEST(GridWalkerTest, partitioning)
+{
   this->check_partitioning();
 }
+
+TYPED_TEST(GridWalkerTest, weighted_partitioning)
+{
+  this->check_weighted_partitioning();
+}
+
+TYPED_TEST(GridWalkerTest, space_filling_curve_partitioning)
+{
+  this->check_space_filling_curve_partitioning();
+}
+
+
+#if HAVE_DUNE_ALUGRID || HAVE_DUNE_UGGRID || HAVE_UG
+
+//! hierarchic walks on locally refined grids, whose elements have different numbers of descendants
+template <class G>
+struct LocallyRefinedHierarchicWalkerTest : public ::testing::Test
+{
+  void check()
+  {
+    auto grid_provider = make_cube_grid<G>(0., 1., 4);
+    auto& grid = grid_provider.grid();
+    // refine towards the left boundary twice
+    for (const double limit : {0.5, 0.25}) {
+      for (auto&& element : elements(grid.leafGridView()))
+        if (element.geometry().center()[0] < limit)
+          grid.mark(1, element);
+      grid.preAdapt();
+      grid.adapt();
+      grid.postAdapt();
+    }
+    ASSERT_LE(2, grid.maxLevel());
+    walk_hierarchy_and_check(grid);
+  }
+};
+
+// clang-format off
+typedef testing::Types<
+#if HAVE_DUNE_ALUGRID
+                       ALU_2D_SIMPLEX_CONFORMING, ALU_2D_CUBE
+#if HAVE_DUNE_UGGRID || HAVE_UG
+                       ,
+#endif
+#endif
+#if HAVE_DUNE_UGGRID || HAVE_UG
+                       UG_2D
+#endif
+                       > LocallyRefinedGrids; // clang-format on
+
+TYPED_TEST_CASE(LocallyRefinedHierarchicWalkerTest, LocallyRefinedGrids);
+TYPED_TEST(LocallyRefinedHierarchicWalkerTest, uneven_descendants)
+{
+  this->check();
+}
+
+#endif // HAVE_DUNE_ALUGRID || HAVE_DUNE_UGGRID || HAVE_UG
@@ -0,0 +1,141 @@
+// This file is part of the dune-xt-grid project:
+//   https://github.com/dune-community/dune-xt-grid
+// Copyright 2009-2018 dune-xt-grid developers and contributors. All rights reserved.
+// License: Dual licensed as BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+//      or  GPL-2.0+ (http://opensource.org/licenses/gpl-license)
+//          with "runtime exception" (http://www.dune-project.org/license.html)
+
+#include <dune/xt/common/test/main.hxx>
+
+#include <atomic>
+#include <vector>
+
+#include <dune/grid/common/datahandleif.hh>
+
+#include <dune/xt/grid/gridprovider/cube.hh>
+#include <dune/xt/grid/walker.hh>
+
+using namespace Dune;
+using namespace Dune::XT::Grid;
+
+
+typedef YaspGrid<2, EquidistantOffsetCoordinates<double, 2>> GridType;
+typedef typename GridType::LeafGridView GridLayerType;
+using EntityType = extract_entity_t<GridLayerType>;
+
+
+//! Sends the value of each element from its interior copy to all other copies.
+class ElementDataHandle : public CommDataHandleIF<ElementDataHandle, double>
+{
+public:
+  ElementDataHandle(const GridLayerType& grid_layer, std::vector<double>& data)
+    : grid_layer_(grid_layer)
+    , data_(data)
+  {
+  }
+
+  bool contains(int /*dim*/, int codim) const
+  {
+    return codim == 0;
+  }
+
+  bool fixedsize(int /*dim*/, int /*codim*/) const
+  {
+    return true;
+  }
+
+  template <class E>
+  size_t size(const E& /*entity*/) const
+  {
+    return 1;
+  }
+
+  template <class MessageBuffer, class E>
+  void gather(MessageBuffer& buffer, const E& entity) const
+  {
+    buffer.write(data_[grid_layer_.indexSet().index(entity)]);
+  }
+
+  template <class MessageBuffer, class E>
+  void scatter(MessageBuffer& buffer, const E& entity, size_t /*n*/)
+  {
+    buffer.read(data_[grid_layer_.indexSet().index(entity)]);
+  }
+
+private:
+  const GridLayerType grid_layer_;
+  std::vector<double>& data_;
+}; // class ElementDataHandle
+
+
+struct OverlappingWalkTest : public ::testing::Test
+{
+  OverlappingWalkTest()
+    : grid_provider_(make_cube_grid<GridType>(0., 1., 8, 0, 1))
+  {
+  }
+
+  static double value(const EntityType& element)
+  {
+    const auto center = element.geometry().center();
+    return center[0] + 10 * center[1];
+  }
+
+  //! The elements walked before the communication, \sa Walker::walk_overlapping
+  static bool at_process_boundary(const EntityType& element)
+  {
+    if (element.partitionType() != InteriorEntity)
+      return true;
+    for (unsigned int ii = 0; ii < element.subEntities(2); ++ii)
+      if (element.template subEntity<2>(ii).partitionType() != InteriorEntity)
+        return true;
+    return false;
+  }
+
+  void check(const bool use_handle, const bool use_tbb)
+  {
+    const auto gv = grid_provider_.leaf_view();
+    const auto& index_set = gv.indexSet();
+    std::vector<double> data(index_set.size(0), -1.);
+    ElementDataHandle handle(gv, data);
+    std::atomic<bool> communication_started(false);
+    std::atomic<size_t> element_count(0), late_elements(0);
+    Walker<GridLayerType> walker(gv);
+    // the values of the interior elements are computed in the walk and sent to the other processes
+    walker.append([&](const EntityType& element) {
+      element_count++;
+      if (communication_started && at_process_boundary(element))
+        late_elements++;
+      if (element.partitionType() == InteriorEntity)
+        data[index_set.index(element)] = value(element);
+    });
+    if (use_handle)
+      walker.walk_overlapping(handle, InteriorBorder_All_Interface, ForwardCommunication, use_tbb);
+    else
+      walker.walk_overlapping(
+          [&] {
+            communication_started = true;
+            gv.communicate(handle, InteriorBorder_All_Interface, ForwardCommunication);
+          },
+          use_tbb);
+    EXPECT_EQ(size_t(gv.size(0)), element_count);
+    EXPECT_EQ(size_t(0), late_elements);
+    for (auto&& element : elements(gv))
+      EXPECT_DOUBLE_EQ(value(element), data[index_set.index(element)]);
+  } // ... check(...)
+
+  const GridProvider<GridType, none_t> grid_provider_;
+}; // struct OverlappingWalkTest
+
+
+TEST_F(OverlappingWalkTest, border_is_walked_before_communication)
+{
+  for (const bool use_tbb : {false, true})
+    this->check(false, use_tbb);
+}
+
+TEST_F(OverlappingWalkTest, data_is_exchanged)
+{
+  for (const bool use_tbb : {false, true})
+    this->check(true, use_tbb);
+}
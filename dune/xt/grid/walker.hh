@@ -12,26 +12,40 @@
 #ifndef DUNE_XT_GRID_WALKER_HH
 #define DUNE_XT_GRID_WALKER_HH
 
+#include <atomic>
+#include <chrono>
 #include <functional>
+#include <future>
+#include <map>
 #include <memory>
+#include <set>
+#include <thread>
 #include <type_traits>
+#include <typeinfo>
 #include <vector>
 
 #if HAVE_TBB
 #include <tbb/blocked_range.h>
 #include <tbb/parallel_reduce.h>
+#include <tbb/task_group.h>
 #include <tbb/tbb_stddef.h>
 #endif
 
+#include <dune/common/classname.hh>
 #include <dune/common/deprecated.hh>
 #include <dune/common/unused.hh>
 #include <dune/common/version.hh>
 
+#include <dune/grid/common/datahandleif.hh>
+#include <dune/grid/common/gridenums.hh>
 #include <dune/grid/common/rangegenerators.hh>
 
 #if HAVE_TBB
 #include <dune/xt/grid/parallel/partitioning/ranged.hh>
 #endif
+#include <dune/xt/grid/parallel/partitioning/colored.hh>
+#include <dune/xt/grid/parallel/partitioning/weighted.hh>
+#include <dune/xt/common/memory.hh>
 #include <dune/xt/common/parallel/threadmanager.hh>
 #include <dune/xt/common/ranges.hh>
 #include <dune/xt/common/unused.hh>
@@ -43,6 +57,11 @@
 
 #include <dune/xt/grid/walker/apply-on.hh>
 #include <dune/xt/grid/walker/functors.hh>
+#include <dune/xt/grid/walker/geometry-cache.hh>
+#include <dune/xt/grid/walker/hierarchic.hh>
+#include <dune/xt/grid/walker/instrumentation.hh>
+#include <dune/xt/grid/walker/plan.hh>
+#include <dune/xt/grid/walker/static.hh>
 #include <dune/xt/grid/walker/wrapper.hh>
 
 namespace Dune {
@@ -60,6 +79,8 @@ public:
   typedef GridLayerImp GridLayerType;
   using EntityType = extract_entity_t<GridLayerType>;
   using IntersectionType = extract_intersection_t<GridLayerType>;
+  typedef WalkPlan<GridLayerType> WalkPlanType;
+  typedef GeometryCache<GridLayerType> GeometryCacheType;
 
   explicit Walker(GridLayerType grd_lr)
     : grid_layer_(grd_lr)
@@ -81,8 +102,15 @@ public:
     return grid_layer_;
   }
 
+  /**
+   * \note All append methods take ownership of the given filters, except for the shared singletons
+   *       ApplyOn::all_entities() and ApplyOn::all_intersections() used by default. For these (and any other
+   *       ApplyOn::AllEntities or ApplyOn::AllIntersections), the walker does not call apply_on during the walk.
+   * \note Appended lambdas (including those appended by append_indexed) are shared by all threads of a parallel walk,
+   *       i.e. they are called concurrently and need to be thread safe, \sa copy.
+   */
   ThisType& append(std::function<void(const EntityType&)> lambda,
-                   const ApplyOn::WhichEntity<GridLayerType>* where = new ApplyOn::AllEntities<GridLayerType>())
+                   const ApplyOn::WhichEntity<GridLayerType>* where = ApplyOn::all_entities<GridLayerType>())
   {
     codim0_functors_.emplace_back(new internal::Codim0LambdaWrapper<GridLayerType>(lambda, where));
     return *this;
@@ -90,14 +118,72 @@ public:
 
   ThisType&
   append(std::function<void(const IntersectionType&, const EntityType&, const EntityType&)> lambda,
-         const ApplyOn::WhichIntersection<GridLayerType>* where = new ApplyOn::AllIntersections<GridLayerType>())
+         const ApplyOn::WhichIntersection<GridLayerType>* where = ApplyOn::all_intersections<GridLayerType>())
   {
     codim1_functors_.emplace_back(new internal::Codim1LambdaWrapper<GridLayerType>(lambda, where));
+    check_inner_intersections_once(codim1_functors_);
+    return *this;
+  }
+
+  /**
+   * \brief Like append(lambda, where), but the lambda is also given the index of the element.
+   *
+   * The index is computed once per element for all indexed lambdas.
+   */
+  ThisType& append_indexed(std::function<void(const EntityType&, const size_t)> lambda,
+                           const ApplyOn::WhichEntity<GridLayerType>* where = ApplyOn::all_entities<GridLayerType>())
+  {
+    indexed_codim0_functors_.emplace_back(new internal::IndexedCodim0LambdaWrapper<GridLayerType>(lambda, where));
+    return *this;
+  }
+
+  /**
+   * \brief Like append(lambda, where), but the lambda is given the indices of the inside and outside element and the
+   *        local numbers of the intersection instead of the elements, \sa Functor::IntersectionIndices.
+   *
+   * The indices are computed once per intersection for all indexed lambdas. When replaying a walk plan (\sa
+   * use_walk_plan), they are taken from the plan and, if no other codim 1 functors are appended, no entities are
+   * created for the outside elements at all.
+   */
+  ThisType& append_indexed(
+      std::function<void(const IntersectionType&, const Functor::IntersectionIndices&)> lambda,
+      const ApplyOn::WhichIntersection<GridLayerType>* where = ApplyOn::all_intersections<GridLayerType>())
+  {
+    indexed_codim1_functors_.emplace_back(new internal::IndexedCodim1LambdaWrapper<GridLayerType>(lambda, where));
+    check_inner_intersections_once(indexed_codim1_functors_);
+    return *this;
+  }
+
+  /**
+   * \brief Applies the lambda on the index of each element.
+   *
+   * When replaying a walk plan (\sa use_walk_plan) and only such lambdas are appended, the walk is carried out on the
+   * arrays of the plan alone, without creating any element or intersection.
+   */
+  ThisType& append_indexed(std::function<void(const size_t)> lambda)
+  {
+    element_index_functors_.emplace_back(std::make_shared<std::function<void(const size_t)>>(lambda));
+    return *this;
+  }
+
+  /**
+   * \brief Applies the lambda on the indices of each intersection,
+   *        \sa append_indexed(std::function<void(const size_t)>)
+   * \note  Throws if inner intersections are visited only once, \sa visit_inner_intersections_once
+   */
+  ThisType& append_indexed(std::function<void(const Functor::IntersectionIndices&)> lambda)
+  {
+    if (visit_inner_intersections_once_)
+      DUNE_THROW(Common::Exceptions::you_are_using_this_wrong,
+                 "Lambdas on the indices of all intersections would miss one side of each inner intersection, use "
+                 "append_indexed(lambda, where) with a filter selecting inner intersections once instead!");
+    intersection_index_functors_.emplace_back(
+        std::make_shared<std::function<void(const Functor::IntersectionIndices&)>>(lambda));
     return *this;
   }
 
   ThisType& append(Functor::Codim0<GridLayerType>& functor,
-                   const ApplyOn::WhichEntity<GridLayerType>* where = new ApplyOn::AllEntities<GridLayerType>())
+                   const ApplyOn::WhichEntity<GridLayerType>* where = ApplyOn::all_entities<GridLayerType>())
   {
     codim0_functors_.emplace_back(
         new internal::Codim0FunctorWrapper<GridLayerType, Functor::Codim0<GridLayerType>>(functor, where));
@@ -106,69 +192,277 @@ public:
 
   ThisType&
   append(Functor::Codim1<GridLayerType>& functor,
-         const ApplyOn::WhichIntersection<GridLayerType>* where = new ApplyOn::AllIntersections<GridLayerType>())
+         const ApplyOn::WhichIntersection<GridLayerType>* where = ApplyOn::all_intersections<GridLayerType>())
   {
     codim1_functors_.emplace_back(
         new internal::Codim1FunctorWrapper<GridLayerType, Functor::Codim1<GridLayerType>>(functor, where));
+    check_inner_intersections_once(codim1_functors_);
+    return *this;
+  }
+
+  /**
+   * \brief Applies the functor once on each sub-entity of the elements selected by where, \sa Functor::CodimN.
+   */
+  template <size_t codim>
+  ThisType& append(Functor::CodimN<GridLayerType, codim>& functor,
+                   const ApplyOn::WhichEntity<GridLayerType>* where = ApplyOn::all_entities<GridLayerType>())
+  {
+    codim0_functors_.emplace_back(
+        new internal::CodimNFunctorWrapper<GridLayerType, codim>(grid_layer_, functor, where));
+    return *this;
+  }
+
+  /**
+   * \brief Applies the functor on batches of the elements selected by where, \sa Functor::Codim0Batch.
+   */
+  template <size_t batch_size>
+  ThisType& append(Functor::Codim0Batch<GridLayerType, batch_size>& functor,
+                   const ApplyOn::WhichEntity<GridLayerType>* where = ApplyOn::all_entities<GridLayerType>())
+  {
+    codim0_functors_.emplace_back(
+        new internal::Codim0BatchWrapper<GridLayerType, batch_size>(grid_layer_, functor, where));
     return *this;
   }
 
   ThisType&
   append(Functor::Codim0And1<GridLayerType>& functor,
-         const ApplyOn::WhichEntity<GridLayerType>* which_entities = new ApplyOn::AllEntities<GridLayerType>(),
+         const ApplyOn::WhichEntity<GridLayerType>* which_entities = ApplyOn::all_entities<GridLayerType>(),
          const ApplyOn::WhichIntersection<GridLayerType>* which_intersections =
-             new ApplyOn::AllIntersections<GridLayerType>())
+             ApplyOn::all_intersections<GridLayerType>())
   {
-    codim0_functors_.emplace_back(
-        new internal::Codim0FunctorWrapper<GridLayerType, Functor::Codim0And1<GridLayerType>>(functor, which_entities));
     codim1_functors_.emplace_back(new internal::Codim1FunctorWrapper<GridLayerType, Functor::Codim0And1<GridLayerType>>(
         functor, which_intersections));
+    check_inner_intersections_once(codim1_functors_);
+    codim0_functors_.emplace_back(
+        new internal::Codim0FunctorWrapper<GridLayerType, Functor::Codim0And1<GridLayerType>>(functor, which_entities));
     return *this;
   }
 
   ThisType&
   append(Functor::Codim0And1<GridLayerType>& functor,
          const ApplyOn::WhichIntersection<GridLayerType>* which_intersections,
-         const ApplyOn::WhichEntity<GridLayerType>* which_entities = new ApplyOn::AllEntities<GridLayerType>())
+         const ApplyOn::WhichEntity<GridLayerType>* which_entities = ApplyOn::all_entities<GridLayerType>())
   {
-    codim0_functors_.emplace_back(
-        new internal::Codim0FunctorWrapper<GridLayerType, Functor::Codim0And1<GridLayerType>>(functor, which_entities));
     codim1_functors_.emplace_back(new internal::Codim1FunctorWrapper<GridLayerType, Functor::Codim0And1<GridLayerType>>(
         functor, which_intersections));
+    check_inner_intersections_once(codim1_functors_);
+    codim0_functors_.emplace_back(
+        new internal::Codim0FunctorWrapper<GridLayerType, Functor::Codim0And1<GridLayerType>>(functor, which_entities));
     return *this;
   }
 
   ThisType&
   append(ThisType& other,
-         const ApplyOn::WhichEntity<GridLayerType>* which_entities = new ApplyOn::AllEntities<GridLayerType>(),
+         const ApplyOn::WhichEntity<GridLayerType>* which_entities = ApplyOn::all_entities<GridLayerType>(),
          const ApplyOn::WhichIntersection<GridLayerType>* which_intersections =
-             new ApplyOn::AllIntersections<GridLayerType>())
+             ApplyOn::all_intersections<GridLayerType>())
   {
     if (&other == this)
       DUNE_THROW(Common::Exceptions::you_are_using_this_wrong, "Do not append a Walker to itself!");
-    codim0_functors_.emplace_back(new internal::WalkerWrapper<GridLayerType, ThisType>(other, which_entities));
     codim1_functors_.emplace_back(new internal::WalkerWrapper<GridLayerType, ThisType>(other, which_intersections));
+    check_inner_intersections_once(codim1_functors_);
+    codim0_functors_.emplace_back(new internal::WalkerWrapper<GridLayerType, ThisType>(other, which_entities));
     return *this;
   } // ... append(...)
 
   ThisType&
   append(ThisType& other,
          const ApplyOn::WhichIntersection<GridLayerType>* which_intersections,
-         const ApplyOn::WhichEntity<GridLayerType>* which_entities = new ApplyOn::AllEntities<GridLayerType>())
+         const ApplyOn::WhichEntity<GridLayerType>* which_entities = ApplyOn::all_entities<GridLayerType>())
   {
     if (&other == this)
       DUNE_THROW(Common::Exceptions::you_are_using_this_wrong, "Do not append a Walker to itself!");
-    codim0_functors_.emplace_back(new internal::WalkerWrapper<GridLayerType, ThisType>(other, which_entities));
     codim1_functors_.emplace_back(new internal::WalkerWrapper<GridLayerType, ThisType>(other, which_intersections));
+    check_inner_intersections_once(codim1_functors_);
+    codim0_functors_.emplace_back(new internal::WalkerWrapper<GridLayerType, ThisType>(other, which_entities));
     return *this;
   } // ... append(...)
 
+  /**
+   * \brief Takes over all functors appended to other, so that they are applied in the next walk of this walker.
+   *
+   * Use this to execute several independent walkers on the same grid layer in one traversal:
+\code
+walker.fuse(assembler).fuse(estimator).walk(true);
+\endcode
+   * In contrast to append(other), the functors of other are called directly instead of through other, and other is
+   * left without functors (as after its own walk). The walk is carried out with the settings of this walker.
+   *
+   * \note Throws if the walkers are not independent, i.e. if other is not a Walker (but derived from it), lives on a
+   *       different grid layer, visits inner intersections differently, or if one of the walkers is appended to the
+   *       other or both have the same walker appended. The functors themselves must not depend on each others results.
+   */
+  ThisType& fuse(ThisType& other)
+  {
+    if (&other == this)
+      DUNE_THROW(Common::Exceptions::you_are_using_this_wrong, "Do not fuse a Walker with itself!");
+    if (typeid(other) != typeid(ThisType))
+      DUNE_THROW(Common::Exceptions::wrong_input_given,
+                 "Can only fuse plain walkers, use append() for derived walkers!\n   other is a "
+                     << Dune::className(other));
+    if (&other.grid_layer_.indexSet() != &grid_layer_.indexSet())
+      DUNE_THROW(Common::Exceptions::wrong_input_given, "Can only fuse walkers on the same grid layer!");
+    if (other.visit_inner_intersections_once_ != visit_inner_intersections_once_)
+      DUNE_THROW(Common::Exceptions::you_are_using_this_wrong,
+                 "Can only fuse walkers which visit inner intersections alike (see visit_inner_intersections_once)!");
+    std::set<const ThisType*> nested_in_this;
+    std::set<const ThisType*> nested_in_other;
+    nested_walkers(nested_in_this);
+    other.nested_walkers(nested_in_other);
+    if (nested_in_other.count(this) > 0 || nested_in_this.count(&other) > 0)
+      DUNE_THROW(Common::Exceptions::you_are_using_this_wrong, "Can not fuse a walker with a walker appended to it!");
+    for (const auto& nested : nested_in_other)
+      if (nested_in_this.count(nested) > 0)
+        DUNE_THROW(Common::Exceptions::you_are_using_this_wrong,
+                   "Can not fuse walkers which have the same walker appended!");
+    for (auto& functor : other.codim0_functors_)
+      codim0_functors_.emplace_back(std::move(functor));
+    for (auto& functor : other.codim1_functors_)
+      codim1_functors_.emplace_back(std::move(functor));
+    for (auto& functor : other.indexed_codim0_functors_)
+      indexed_codim0_functors_.emplace_back(std::move(functor));
+    for (auto& functor : other.indexed_codim1_functors_)
+      indexed_codim1_functors_.emplace_back(std::move(functor));
+    for (auto& functor : other.element_index_functors_)
+      element_index_functors_.emplace_back(std::move(functor));
+    for (auto& functor : other.intersection_index_functors_)
+      intersection_index_functors_.emplace_back(std::move(functor));
+    other.clear();
+    return *this;
+  } // ... fuse(...)
+
   void clear()
   {
     codim0_functors_.clear();
     codim1_functors_.clear();
+    indexed_codim0_functors_.clear();
+    indexed_codim1_functors_.clear();
+    element_index_functors_.clear();
+    intersection_index_functors_.clear();
+    visited_inner_intersections_ = nullptr;
   } // ... clear()
 
+  /**
+   * \brief Visit each inner intersection only once (from the side from which it is reached first) in walk().
+   *
+   * All codim 1 functors (including those of appended walkers) then see each inner intersection only once, together
+   * with both neighbors. This saves every second outside() construction and evaluation of the ApplyOn filters for
+   * inner intersections, and functors using ApplyOn::InnerIntersectionsPrimally are applied without evaluating their
+   * filter at all. Boundary, periodic and nonconforming intersections are visited as usual.
+   *
+   * \note Throws (as does appending a codim 1 functor afterwards) unless all codim 1 functors and lambdas use a
+   *       filter which selects inner intersections once, so that no functor silently misses one side of an inner
+   *       intersection, \sa ApplyOn::WhichIntersection::selects_inner_intersections_once. Requires the index set of
+   *       the grid layer to provide indices for codim 1.
+   */
+  ThisType& visit_inner_intersections_once(const bool value = true)
+  {
+    if (value && !selects_inner_intersections_once())
+      DUNE_THROW(Common::Exceptions::you_are_using_this_wrong,
+                 "Not all codim 1 functors use a filter selecting inner intersections once, they would miss one side "
+                 "of each inner intersection!");
+    visit_inner_intersections_once_ = value;
+    return *this;
+  }
+
+  //! Whether all codim 1 functors select inner intersections once, \sa visit_inner_intersections_once
+  bool selects_inner_intersections_once() const
+  {
+    for (const auto& functor : codim1_functors_)
+      if (!functor->selects_inner_intersections_once())
+        return false;
+    for (const auto& functor : indexed_codim1_functors_)
+      if (!functor->selects_inner_intersections_once())
+        return false;
+    return intersection_index_functors_.empty();
+  }
+
+  /**
+   * \brief Replay a WalkPlan in walk() instead of iterating the grid layer.
+   *
+   * Elements are then created from the seeds of the plan, inner intersections are visited once without bookkeeping
+   * (\sa visit_inner_intersections_once), indexed functors obtain all indices from the plan, and the parallel walk
+   * splits the plan directly instead of partitioning the grid layer in each walk. If only lambdas on indices are
+   * appended (\sa append_indexed), neither elements nor intersections are created at all. The plan is updated in
+   * walk() if it is no longer valid.
+   *
+   * \note The plan may be shared between several walkers on the same grid layer. Unless WalkPlan::exact, call
+   *       WalkPlan::invalidate() after each adaptation of the grid.
+   */
+  ThisType& use_walk_plan(std::shared_ptr<WalkPlanType> plan)
+  {
+    walk_plan_ = plan;
+    return *this;
+  }
+
+  /**
+   * \brief Records call counts, timings and filter rejections of all appended functors in the following walks.
+   *
+   * The functors are decorated at the beginning of each walk, so there is no overhead if this is disabled. The
+   * results are available by statistics() after the walk and are logged to XT::Common::TimedLogger().get(
+   * "xt.grid.walker").info().
+   *
+   * \note Only the functors appended by append() are decorated. A Functor::CodimN or Functor::Codim0Batch is recorded
+   *       as a codim 0 functor, i.e. one call comprises all sub-entities of an element or the filling of a batch.
+   *       Lambdas appended by append_indexed are not instrumented, the time spent in them is contained in
+   *       WalkerStatistics::overhead_seconds(). Functor::FatherChild functors are walked by a HierarchicWalker, which
+   *       does not support instrumentation.
+   */
+  ThisType& instrument(const bool value = true)
+  {
+    instrument_ = value;
+    return *this;
+  }
+
+  //! Results of the last instrumented walk, \sa instrument
+  const WalkerStatistics& statistics() const
+  {
+    return statistics_;
+  }
+
+  //! \sa use_walk_plan
+  ThisType& use_walk_plan(const bool value = true)
+  {
+    if (!value)
+      walk_plan_ = nullptr;
+    else if (!walk_plan_)
+      walk_plan_ = std::make_shared<WalkPlanType>(grid_layer_);
+    return *this;
+  }
+
+  const std::shared_ptr<WalkPlanType>& walk_plan() const
+  {
+    return walk_plan_;
+  }
+
+  /**
+   * \brief Updates the given cache before the functors are prepared in each walk, if it is no longer valid.
+   *
+   * Hand the same cache to all functors which need geometry data, so that it is computed only once per grid layer.
+   *
+   * \note The cache may be shared between several walkers on the same grid layer.
+   */
+  ThisType& use_geometry_cache(std::shared_ptr<GeometryCacheType> cache)
+  {
+    geometry_cache_ = cache;
+    return *this;
+  }
+
+  //! \sa use_geometry_cache
+  ThisType& use_geometry_cache(const bool value = true)
+  {
+    if (!value)
+      geometry_cache_ = nullptr;
+    else if (!geometry_cache_)
+      geometry_cache_ = std::make_shared<GeometryCacheType>(grid_layer_);
+    return *this;
+  }
+
+  const std::shared_ptr<GeometryCacheType>& geometry_cache() const
+  {
+    return geometry_cache_;
+  }
+
   virtual void prepare()
   {
     for (auto& functor : codim0_functors_)
@@ -180,34 +474,92 @@ public:
   bool apply_on(const EntityType& entity) const
   {
     for (const auto& functor : codim0_functors_)
+      if (functor->selects_all() || functor->apply_on(grid_layer_, entity))
+        return true;
+    for (const auto& functor : indexed_codim0_functors_)
       if (functor->apply_on(grid_layer_, entity))
         return true;
-    return false;
+    return !element_index_functors_.empty();
   } // ... apply_on(...)
 
   bool apply_on(const IntersectionType& intersection) const
+  {
+    return apply_on(intersection, intersection.inside());
+  }
+
+  //! \sa apply_on(intersection)
+  bool apply_on(const IntersectionType& intersection, const EntityType& inside_entity) const
   {
     for (const auto& functor : codim1_functors_)
-      if (functor->apply_on(grid_layer_, intersection))
+      if (functor->selects_all() || functor->apply_on(grid_layer_, intersection, inside_entity))
         return true;
-    return false;
+    if (!indexed_codim1_functors_.empty()) {
+      const size_t inside_index = grid_layer_.indexSet().index(inside_entity);
+      for (const auto& functor : indexed_codim1_functors_)
+        if (functor->apply_on(grid_layer_, intersection, inside_index))
+          return true;
+    }
+    return !intersection_index_functors_.empty();
   } // ... apply_on(...)
 
+  //! \sa visit_inner_intersections_once
+  bool apply_on_once(const IntersectionType& intersection) const
+  {
+    return apply_on_once(intersection, intersection.inside());
+  }
+
+  //! \sa visit_inner_intersections_once
+  bool apply_on_once(const IntersectionType& intersection, const EntityType& inside_entity) const
+  {
+    for (const auto& functor : codim1_functors_)
+      if (functor->selects_all() || functor->apply_on_once(grid_layer_, intersection, inside_entity))
+        return true;
+    if (!indexed_codim1_functors_.empty()) {
+      const size_t inside_index = grid_layer_.indexSet().index(inside_entity);
+      for (const auto& functor : indexed_codim1_functors_)
+        if (functor->apply_on_once(grid_layer_, intersection, inside_index))
+          return true;
+    }
+    return !intersection_index_functors_.empty();
+  } // ... apply_on_once(...)
+
   virtual void apply_local(const EntityType& entity)
   {
     for (auto& functor : codim0_functors_)
-      if (functor->apply_on(grid_layer_, entity))
+      if (functor->selects_all() || functor->apply_on(grid_layer_, entity))
         functor->apply_local(entity);
+    if (!indexed_codim0_functors_.empty() || !element_index_functors_.empty()) {
+      const size_t index = grid_layer_.indexSet().index(entity);
+      for (auto& functor : indexed_codim0_functors_)
+        if (functor->apply_on(grid_layer_, entity))
+          functor->apply_local(entity, index);
+      for (auto& functor : element_index_functors_)
+        (*functor)(index);
+    }
   } // ... apply_local(...)
 
   virtual void
   apply_local(const IntersectionType& intersection, const EntityType& inside_entity, const EntityType& outside_entity)
   {
     for (auto& functor : codim1_functors_)
-      if (functor->apply_on(grid_layer_, intersection))
+      if (functor->selects_all() || functor->apply_on(grid_layer_, intersection, inside_entity))
         functor->apply_local(intersection, inside_entity, outside_entity);
+    if (has_indexed_codim1_functors())
+      apply_indexed(intersection, intersection_indices(intersection, inside_entity, outside_entity));
   } // ... apply_local(...)
 
+  //! \sa visit_inner_intersections_once
+  virtual void apply_local_once(const IntersectionType& intersection,
+                                const EntityType& inside_entity,
+                                const EntityType& outside_entity)
+  {
+    for (auto& functor : codim1_functors_)
+      if (functor->selects_all() || functor->apply_on_once(grid_layer_, intersection, inside_entity))
+        functor->apply_local_once(intersection, inside_entity, outside_entity);
+    if (has_indexed_codim1_functors())
+      apply_indexed_once(intersection, intersection_indices(intersection, inside_entity, outside_entity));
+  } // ... apply_local_once(...)
+
   virtual void finalize()
   {
     for (auto& functor : codim0_functors_)
@@ -216,45 +568,129 @@ public:
       functor->finalize();
   } // ... finalize()
 
-  void walk(const bool use_tbb = false)
+  /**
+   * \brief Returns a walker with thread local copies of all appended functors, \sa Functor::Codim0.
+   *
+   * Returns nullptr for classes derived from Walker (which do not override this method), so that these are shared
+   * among all threads as a whole instead of losing their behaviour in a plain copy.
+   *
+   * \note Appended lambdas are not copied but shared with the returned walker. A Functor::Codim0And1 (including an
+   *       appended walker) is copied only once, the same copy is applied by its codim 0 and its codim 1 part and
+   *       joined once.
+   */
+  virtual ThisType* copy() override
   {
-#if HAVE_TBB
-    if (use_tbb) {
-      const auto num_partitions =
-          DXTC_CONFIG_GET("threading.partition_factor", 1u) * XT::Common::threadManager().current_threads();
-      RangedPartitioning<GridLayerType, 0> partitioning(grid_layer_, num_partitions);
-      this->walk(partitioning);
-      return;
+    if (typeid(*this) != typeid(ThisType))
+      return nullptr;
+    auto ret = Common::make_unique<ThisType>(grid_layer_);
+    ret->visit_inner_intersections_once_ = visit_inner_intersections_once_;
+    ret->visited_inner_intersections_ = visited_inner_intersections_;
+    std::map<const Functor::Codim0And1<GridLayerType>*, Functor::Codim0And1<GridLayerType>*> codim0and1_copies;
+    for (auto& functor : codim0_functors_) {
+      ret->codim0_functors_.emplace_back(functor->copy());
+      if (const auto codim0and1_functor = functor->codim0and1_functor())
+        codim0and1_copies[codim0and1_functor] = ret->codim0_functors_.back()->codim0and1_functor();
     }
-#else
-    DUNE_UNUSED_PARAMETER(use_tbb);
-#endif
+    for (auto& functor : codim1_functors_) {
+      const auto codim0and1_copy = codim0and1_copies.find(functor->codim0and1_functor());
+      if (codim0and1_copy != codim0and1_copies.end())
+        ret->codim1_functors_.emplace_back(functor->copy_with(*codim0and1_copy->second));
+      else
+        ret->codim1_functors_.emplace_back(functor->copy());
+    }
+    for (const auto& functor : indexed_codim0_functors_)
+      ret->indexed_codim0_functors_.emplace_back(functor->copy());
+    for (const auto& functor : indexed_codim1_functors_)
+      ret->indexed_codim1_functors_.emplace_back(functor->copy());
+    ret->element_index_functors_ = element_index_functors_;
+    ret->intersection_index_functors_ = intersection_index_functors_;
+    return ret.release();
+  } // ... copy()
+
+  virtual void join(Functor::Codim0And1<GridLayerType>& other) override
+  {
+    auto& other_walker = dynamic_cast<ThisType&>(other);
+    if (other_walker.codim0_functors_.size() != codim0_functors_.size()
+        || other_walker.codim1_functors_.size() != codim1_functors_.size()
+        || other_walker.indexed_codim0_functors_.size() != indexed_codim0_functors_.size()
+        || other_walker.indexed_codim1_functors_.size() != indexed_codim1_functors_.size()
+        || other_walker.element_index_functors_.size() != element_index_functors_.size()
+        || other_walker.intersection_index_functors_.size() != intersection_index_functors_.size())
+      DUNE_THROW(Common::Exceptions::you_are_using_this_wrong, "Can only join copies of this walker!");
+    for (size_t ii = 0; ii < codim0_functors_.size(); ++ii)
+      codim0_functors_[ii]->join(*other_walker.codim0_functors_[ii]);
+    for (size_t ii = 0; ii < codim1_functors_.size(); ++ii)
+      codim1_functors_[ii]->join(*other_walker.codim1_functors_[ii]);
+  } // ... join(...)
+
+  void walk(const bool use_tbb = false)
+  {
     // prepare functors
-    prepare();
+    begin_walk(use_tbb);
 
-    // only do something, if we have to
-    if ((codim0_functors_.size() + codim1_functors_.size()) > 0) {
-      walk_range(elements(grid_layer_));
-    } // only do something, if we have to
+    traverse(use_tbb);
 
     // finalize functors
-    finalize();
-    clear();
+    end_walk();
   } // ... walk(...)
 
+  class AsyncWalk;
+
+  /**
+   * \brief Starts walk(use_tbb) in the background and returns immediately, \sa AsyncWalk.
+   *
+   * The functors are prepared on the calling thread before the traversal starts and are finalized on the thread
+   * calling AsyncWalk::wait(). The walker and all appended functors must not be used in between. If use_tbb is true,
+   * the traversal is started as a TBB task (and may thus be started by the thread calling wait() at the latest if all
+   * other threads of the arena are busy), otherwise on a separate std::thread.
+   */
+  AsyncWalk walk_async(const bool use_tbb = false)
+  {
+    begin_walk(use_tbb);
+    return AsyncWalk(*this, [this, use_tbb] { traverse(use_tbb); }, use_tbb);
+  }
+
 #if HAVE_TBB
 protected:
-  template <class PartioningType, class WalkerType>
-  struct Body
+  /**
+   * Each body created by splitting works on its own copy of the walker (and thus on thread local copies of all
+   * functors which support copying), which are merged again when TBB joins the bodies.
+   */
+  template <class WalkerType>
+  struct BodyBase
   {
-    Body(WalkerType& walker, PartioningType& partitioning)
+    BodyBase(WalkerType& walker)
       : walker_(walker)
+    {
+    }
+
+    BodyBase(BodyBase& other, tbb::split /*split*/)
+      : walker_copy_(other.walker_.copy())
+      , walker_(walker_copy_ ? *walker_copy_ : other.walker_)
+    {
+    }
+
+    void join(BodyBase& other)
+    {
+      if (other.walker_copy_)
+        walker_.join(*other.walker_copy_);
+    }
+
+    std::unique_ptr<WalkerType> walker_copy_;
+    WalkerType& walker_;
+  }; // struct BodyBase
+
+  template <class PartioningType, class WalkerType>
+  struct Body : public BodyBase<WalkerType>
+  {
+    Body(WalkerType& walker, const PartioningType& partitioning)
+      : BodyBase<WalkerType>(walker)
       , partitioning_(partitioning)
     {
     }
 
-    Body(Body& other, tbb::split /*split*/)
-      : walker_(other.walker_)
+    Body(Body& other, tbb::split split)
+      : BodyBase<WalkerType>(other, split)
       , partitioning_(other.partitioning_)
     {
     }
@@ -264,35 +700,67 @@ protected:
       // for all partitions in tbb-range
       for (std::size_t p = range.begin(); p != range.end(); ++p) {
         auto partition = partitioning_.partition(p);
-        walker_.walk_range(partition);
+        this->walker_.walk_range(partition);
       }
     }
 
-    void join(Body& /*other*/)
+    void join(Body& other)
     {
+      BodyBase<WalkerType>::join(other);
     }
 
-    WalkerType& walker_;
     const PartioningType& partitioning_;
   }; // struct Body
 
+  template <class WalkerType>
+  struct PlanBody : public BodyBase<WalkerType>
+  {
+    PlanBody(WalkerType& walker, const WalkPlanType& plan)
+      : BodyBase<WalkerType>(walker)
+      , plan_(plan)
+    {
+    }
+
+    PlanBody(PlanBody& other, tbb::split split)
+      : BodyBase<WalkerType>(other, split)
+      , plan_(other.plan_)
+    {
+    }
+
+    void operator()(const tbb::blocked_range<std::size_t>& range) const
+    {
+      this->walker_.replay_range(plan_, range.begin(), range.end());
+    }
+
+    void join(PlanBody& other)
+    {
+      BodyBase<WalkerType>::join(other);
+    }
+
+    const WalkPlanType& plan_;
+  }; // struct PlanBody
+
+  template <class PartioningType>
+  void traverse(PartioningType& partitioning)
+  {
+    // only do something, if we have to
+    if (has_functors()) {
+      prepare_intersection_visits();
+      traverse_partitions(partitioning, true);
+    }
+  } // ... traverse(...)
+
 public:
   template <class PartioningType>
   void walk(PartioningType& partitioning)
   {
     // prepare functors
-    prepare();
+    begin_walk(true);
 
-    // only do something, if we have to
-    if ((codim0_functors_.size() + codim1_functors_.size()) > 0) {
-      tbb::blocked_range<std::size_t> range(0, partitioning.partitions());
-      Body<PartioningType, ThisType> body(*this, partitioning);
-      tbb::parallel_reduce(range, body);
-    }
+    traverse(partitioning);
 
     // finalize functors
-    finalize();
-    clear();
+    end_walk();
   } // ... tbb_walk(...)
 #else
 public:
@@ -300,21 +768,366 @@ public:
   void walk(PartioningType& partitioning)
   {
     // prepare functors
-    prepare();
+    begin_walk();
 
     // only do something, if we have to
-    if ((codim0_functors_.size() + codim1_functors_.size()) > 0) {
+    if (has_functors()) {
+      prepare_intersection_visits();
       // no actual SMP walk, use range as is
       walk_range(partitioning.everything());
     }
 
     // finalize functors
-    finalize();
-    clear();
+    end_walk();
   } // ... tbb_walk(...)
 #endif // HAVE_TBB
 
+  /**
+   * \brief Walks the colors of the given coloring one after another, the elements of each color in parallel.
+   *
+   * Elements which are processed concurrently do not share a vertex (nor a face neighbor, \sa ColoredPartitioning),
+   * so functors may write to global data associated with the inside and outside elements without locking.
+   */
+  template <class ColoringType>
+  void walk_colored(const ColoringType& coloring, const bool use_tbb = true)
+  {
+    // prepare functors
+    begin_walk(use_tbb);
+
+    // only do something, if we have to
+    if (has_functors()) {
+      prepare_intersection_visits();
+      for (size_t cc = 0; cc < coloring.colors(); ++cc)
+        traverse_partitions(coloring.color(cc), use_tbb);
+    }
+
+    // finalize functors
+    end_walk();
+  } // ... walk_colored(...)
+
+  /**
+   * \brief Overlaps the given (blocking) communication with the traversal of the interior elements.
+   *
+   * First walks all elements at the process boundary (i.e. elements which are not interior or have a vertex which is
+   * not interior), then calls communicate() on the calling thread while the remaining interior elements are walked in
+   * the background (as in walk_async). Returns after both are finished and the functors are finalized.
+   *
+   * \note Functors must not depend on communicated data for interior elements, since it may not have arrived yet.
+   *       Codim 1 functors may still see elements at the process boundary as outside neighbors of interior elements.
+   * \note communicate() is only called from the calling thread, so MPI_THREAD_FUNNELED suffices.
+   */
+  void walk_overlapping(const std::function<void()>& communicate, const bool use_tbb = true)
+  {
+    // prepare functors
+    begin_walk(use_tbb);
+
+    // only do something, if we have to
+    if (!has_functors()) {
+      communicate();
+      end_walk();
+      return;
+    }
+    typedef internal::ColorClassPartitioning<GridLayerType> PhaseType;
+    const auto& index_set = grid_layer_.indexSet();
+    std::vector<typename PhaseType::EntitySeedType> border_seeds, interior_seeds;
+    std::vector<size_t> border_indices, interior_indices;
+    for (auto&& element : elements(grid_layer_)) {
+      bool at_process_boundary = element.partitionType() != InteriorEntity;
+      for (unsigned int ii = 0; !at_process_boundary && ii < element.subEntities(GridLayerType::dimension); ++ii)
+        at_process_boundary =
+            element.template subEntity<GridLayerType::dimension>(ii).partitionType() != InteriorEntity;
+      (at_process_boundary ? border_seeds : interior_seeds).emplace_back(element.seed());
+      (at_process_boundary ? border_indices : interior_indices).emplace_back(index_set.index(element));
+    }
+    const auto num_partitions =
+        DXTC_CONFIG_GET("threading.partition_factor", 8u) * XT::Common::threadManager().current_threads();
+    const PhaseType border(grid_layer_, num_partitions, std::move(border_seeds), std::move(border_indices));
+    auto interior = std::make_shared<const PhaseType>(
+        grid_layer_, num_partitions, std::move(interior_seeds), std::move(interior_indices));
+
+    // the intersection bookkeeping is shared by both phases
+    prepare_intersection_visits();
+    traverse_partitions(border, use_tbb);
+    AsyncWalk interior_walk(*this, [this, interior, use_tbb] { traverse_partitions(*interior, use_tbb); }, use_tbb);
+    try {
+      communicate();
+    } catch (...) {
+      interior_walk.cancel();
+      throw;
+    }
+
+    // finalize functors
+    interior_walk.wait();
+  } // ... walk_overlapping(...)
+
+  //! Overlaps grid_layer().communicate(handle, iftype, dir) with the traversal of the interior elements.
+  template <class DataHandleImp, class DataType>
+  void walk_overlapping(CommDataHandleIF<DataHandleImp, DataType>& handle,
+                        const InterfaceType iftype,
+                        const CommunicationDirection dir,
+                        const bool use_tbb = true)
+  {
+    walk_overlapping([&] { grid_layer_.communicate(handle, iftype, dir); }, use_tbb);
+  }
+
 protected:
+  void begin_walk(const bool parallel = false)
+  {
+    if (instrument_) {
+      walk_start_ = std::chrono::steady_clock::now();
+#if HAVE_TBB
+      walk_threads_ = parallel ? XT::Common::threadManager().current_threads() : 1;
+#else
+      DUNE_UNUSED_PARAMETER(parallel);
+      walk_threads_ = 1;
+#endif
+      for (auto& functor : codim0_functors_)
+        functor.reset(new internal::Codim0Instrumentation<GridLayerType>(std::move(functor)));
+      for (auto& functor : codim1_functors_)
+        functor.reset(new internal::Codim1Instrumentation<GridLayerType>(std::move(functor)));
+    }
+    if (geometry_cache_ && !geometry_cache_->valid())
+      geometry_cache_->update();
+    prepare();
+  } // ... begin_walk(...)
+
+  void end_walk()
+  {
+    finalize();
+    if (instrument_) {
+      statistics_ = WalkerStatistics();
+      statistics_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - walk_start_).count();
+      statistics_.threads = walk_threads_;
+      for (const auto& functor : codim0_functors_)
+        statistics_.functors.push_back(
+            static_cast<const internal::Codim0Instrumentation<GridLayerType>&>(*functor).statistics());
+      for (const auto& functor : codim1_functors_)
+        statistics_.functors.push_back(
+            static_cast<const internal::Codim1Instrumentation<GridLayerType>&>(*functor).statistics());
+      auto logger = XT::Common::TimedLogger().get("xt.grid.walker");
+      statistics_.report(logger.info());
+    }
+    clear();
+  } // ... end_walk(...)
+
+  //! Walks all partitions (in parallel if use_tbb) without resetting the intersection bookkeeping, \sa walk_colored
+  template <class PartitioningType>
+  void traverse_partitions(const PartitioningType& partitioning, const bool use_tbb)
+  {
+#if HAVE_TBB
+    if (use_tbb) {
+      tbb::blocked_range<std::size_t> range(0, partitioning.partitions());
+      Body<PartitioningType, ThisType> body(*this, partitioning);
+      tbb::parallel_reduce(range, body);
+    } else
+      walk_range(partitioning.everything());
+#else
+    DUNE_UNUSED_PARAMETER(use_tbb);
+    walk_range(partitioning.everything());
+#endif
+  } // ... traverse_partitions(...)
+
+  //! Visits all elements and intersections without preparing or finalizing the functors, \sa walk
+  void traverse(const bool use_tbb)
+  {
+    // only do something, if we have to
+    if (!has_functors())
+      return;
+    if (walk_plan_) {
+      replay(*walk_plan_, use_tbb);
+      return;
+    }
+#if HAVE_TBB
+    if (use_tbb) {
+      // many small chunks, which are distributed among the threads by work stealing
+      const auto num_partitions =
+          DXTC_CONFIG_GET("threading.partition_factor", 8u) * XT::Common::threadManager().current_threads();
+      WeightedPartitioning<GridLayerType> partitioning(grid_layer_, num_partitions);
+      traverse(partitioning);
+      return;
+    }
+#else
+    DUNE_UNUSED_PARAMETER(use_tbb);
+#endif
+    prepare_intersection_visits();
+    walk_range(elements(grid_layer_));
+  } // ... traverse(...)
+
+  //! Collects all walkers appended to this one (recursively), \sa fuse
+  void nested_walkers(std::set<const ThisType*>& walkers) const
+  {
+    for (const auto& functor : codim0_functors_) {
+      const auto* wrapper = dynamic_cast<const internal::WalkerWrapper<GridLayerType, ThisType>*>(functor.get());
+      if (wrapper && walkers.insert(&wrapper->walker()).second)
+        wrapper->walker().nested_walkers(walkers);
+    }
+  } // ... nested_walkers(...)
+
+  void replay(WalkPlanType& plan, const bool use_tbb)
+  {
+    if (!plan.valid())
+      plan.update();
+#if HAVE_TBB
+    if (use_tbb) {
+      tbb::blocked_range<std::size_t> range(0, plan.size());
+      PlanBody<ThisType> body(*this, plan);
+      tbb::parallel_reduce(range, body);
+    } else
+      replay_range(plan, 0, plan.size());
+#else
+    DUNE_UNUSED_PARAMETER(use_tbb);
+    replay_range(plan, 0, plan.size());
+#endif
+  } // ... replay(...)
+
+  void replay_range(const WalkPlanType& plan, const size_t first, const size_t last)
+  {
+    if (has_index_functors_only()) {
+      replay_indices(plan, first, last);
+      return;
+    }
+    for (size_t ii = first; ii < last; ++ii) {
+      const auto entity = plan.element(ii);
+      // apply codim0 functors
+      apply_local(entity);
+
+      // only walk the intersections, if there are codim1 functors present
+      if (has_codim1_functors()) {
+        // the intersections are visited in the same order as when the plan was built, \sa walk_range
+        size_t jj = plan.intersections_begin(ii);
+        const auto intersection_it_end = grid_layer_.iend(entity);
+        for (auto intersection_it = grid_layer_.ibegin(entity); intersection_it != intersection_it_end;
+             ++intersection_it, ++jj) {
+          const auto& intersection = *intersection_it;
+          const size_t outside = plan.outside(jj);
+          // the element with the smaller position visits, no bookkeeping required
+          const bool once = visit_inner_intersections_once_ && outside != WalkPlanType::no_neighbor
+                            && !plan.boundary(jj) && plan.conforming(jj);
+          if (once && outside < ii)
+            continue;
+
+          // only indexed functors, the outside element is not required
+          if (codim1_functors_.empty()) {
+            const Functor::IntersectionIndices indices{
+                plan.index(ii), plan.outside_index(jj), plan.index_in_inside(jj), plan.index_in_outside(jj)};
+            if (once)
+              apply_indexed_once(intersection, indices);
+            else
+              apply_indexed(intersection, indices);
+            continue;
+          }
+
+          // apply codim1 functors
+          if (!plan.neighbor(jj))
+            apply_local(intersection, entity, entity);
+          else {
+            const auto neighbor = intersection.outside();
+            if (once)
+              apply_local_once(intersection, entity, neighbor);
+            else
+              apply_local(intersection, entity, neighbor);
+          }
+        } // walk the intersections
+      } // only walk the intersections, if there are codim1 functors present
+    }
+  } // ... replay_range(...)
+
+  //! Replays the plan on its arrays alone, \sa has_index_functors_only
+  void replay_indices(const WalkPlanType& plan, const size_t first, const size_t last)
+  {
+    for (size_t ii = first; ii < last; ++ii) {
+      const size_t index = plan.index(ii);
+      for (auto& functor : element_index_functors_)
+        (*functor)(index);
+      if (intersection_index_functors_.empty())
+        continue;
+      const size_t intersections_end = plan.intersections_end(ii);
+      // never visited once, \sa append_indexed(std::function<void(const Functor::IntersectionIndices&)>)
+      for (size_t jj = plan.intersections_begin(ii); jj < intersections_end; ++jj) {
+        const Functor::IntersectionIndices indices{
+            index, plan.outside_index(jj), plan.index_in_inside(jj), plan.index_in_outside(jj)};
+        for (auto& functor : intersection_index_functors_)
+          (*functor)(indices);
+      }
+    }
+  } // ... replay_indices(...)
+
+  bool has_functors() const
+  {
+    return !codim0_functors_.empty() || !indexed_codim0_functors_.empty() || !element_index_functors_.empty()
+           || has_codim1_functors();
+  }
+
+  bool has_codim1_functors() const
+  {
+    return !codim1_functors_.empty() || has_indexed_codim1_functors();
+  }
+
+  bool has_indexed_codim1_functors() const
+  {
+    return !indexed_codim1_functors_.empty() || !intersection_index_functors_.empty();
+  }
+
+  //! Whether only index lambdas are appended, which do not require any entity or intersection, \sa append_indexed
+  bool has_index_functors_only() const
+  {
+    return codim0_functors_.empty() && indexed_codim0_functors_.empty() && codim1_functors_.empty()
+           && indexed_codim1_functors_.empty();
+  }
+
+  Functor::IntersectionIndices intersection_indices(const IntersectionType& intersection,
+                                                    const EntityType& inside_entity,
+                                                    const EntityType& outside_entity) const
+  {
+    const auto& index_set = grid_layer_.indexSet();
+    const size_t inside = index_set.index(inside_entity);
+    if (!intersection.neighbor())
+      return {inside, inside, int(intersection.indexInInside()), -1};
+    return {inside,
+            size_t(index_set.index(outside_entity)),
+            int(intersection.indexInInside()),
+            int(intersection.indexInOutside())};
+  } // ... intersection_indices(...)
+
+  //! Applies the indexed codim 1 lambdas, \sa append_indexed
+  void apply_indexed(const IntersectionType& intersection, const Functor::IntersectionIndices& indices)
+  {
+    for (auto& functor : indexed_codim1_functors_)
+      if (functor->apply_on(grid_layer_, intersection, indices.inside))
+        functor->apply_local(intersection, indices);
+    for (auto& functor : intersection_index_functors_)
+      (*functor)(indices);
+  }
+
+  //! \sa visit_inner_intersections_once
+  void apply_indexed_once(const IntersectionType& intersection, const Functor::IntersectionIndices& indices)
+  {
+    for (auto& functor : indexed_codim1_functors_)
+      if (functor->apply_on_once(grid_layer_, intersection, indices.inside))
+        functor->apply_local(intersection, indices);
+  }
+
+  //! Removes the functor just appended and throws if it would miss intersections, \sa visit_inner_intersections_once
+  template <class FunctorsType>
+  void check_inner_intersections_once(FunctorsType& functors)
+  {
+    if (visit_inner_intersections_once_ && !functors.back()->selects_inner_intersections_once()) {
+      functors.pop_back();
+      DUNE_THROW(Common::Exceptions::you_are_using_this_wrong,
+                 "Inner intersections are visited only once, but the filter of this functor does not select them once, "
+                 "it would miss one side of each inner intersection!");
+    }
+  } // ... check_inner_intersections_once(...)
+
+  void prepare_intersection_visits()
+  {
+    if (visit_inner_intersections_once_ && has_codim1_functors())
+      visited_inner_intersections_ =
+          std::make_shared<std::vector<std::atomic<bool>>>(grid_layer_.indexSet().size(1));
+    else
+      visited_inner_intersections_ = nullptr;
+  } // ... prepare_intersection_visits(...)
+
   template <class EntityRange>
   void walk_range(const EntityRange& entity_range)
   {
@@ -329,7 +1142,7 @@ protected:
       apply_local(entity);
 
       // only walk the intersections, if there are codim1 functors present
-      if (codim1_functors_.size() > 0) {
+      if (has_codim1_functors()) {
         // walk the intersections, do not use intersections(...) here, since that does not work for a SubdomainGridView
         // which is based on alugrid and then wrapped as a grid view (see also
         // https://github.com/dune-community/dune-xt-grid/issues/26)
@@ -340,8 +1153,17 @@ protected:
 
           // apply codim1 functors
           if (intersection.neighbor()) {
-            const auto neighbor = intersection.outside();
-            apply_local(intersection, entity, neighbor);
+            if (visited_inner_intersections_ && !intersection.boundary() && intersection.conforming()) {
+              // only the first visit of an inner intersection counts, the flag is shared by all threads
+              const auto face_index = grid_layer_.indexSet().subIndex(entity, intersection.indexInInside(), 1);
+              if ((*visited_inner_intersections_)[face_index].exchange(true, std::memory_order_relaxed))
+                continue;
+              const auto neighbor = intersection.outside();
+              apply_local_once(intersection, entity, neighbor);
+            } else {
+              const auto neighbor = intersection.outside();
+              apply_local(intersection, entity, neighbor);
+            }
           } else
             apply_local(intersection, entity, entity);
 
@@ -353,9 +1175,128 @@ protected:
   GridLayerType grid_layer_;
   std::vector<std::unique_ptr<internal::Codim0Object<GridLayerType>>> codim0_functors_;
   std::vector<std::unique_ptr<internal::Codim1Object<GridLayerType>>> codim1_functors_;
+  std::vector<std::unique_ptr<internal::IndexedCodim0LambdaWrapper<GridLayerType>>> indexed_codim0_functors_;
+  std::vector<std::unique_ptr<internal::IndexedCodim1LambdaWrapper<GridLayerType>>> indexed_codim1_functors_;
+  std::vector<std::shared_ptr<std::function<void(const size_t)>>> element_index_functors_;
+  std::vector<std::shared_ptr<std::function<void(const Functor::IntersectionIndices&)>>> intersection_index_functors_;
+  bool visit_inner_intersections_once_ = false;
+  std::shared_ptr<std::vector<std::atomic<bool>>> visited_inner_intersections_;
+  std::shared_ptr<WalkPlanType> walk_plan_;
+  std::shared_ptr<GeometryCacheType> geometry_cache_;
+  bool instrument_ = false;
+  WalkerStatistics statistics_;
+  std::chrono::steady_clock::time_point walk_start_;
+  size_t walk_threads_ = 1;
 }; // class Walker
 
 
+/**
+ * \brief Handle of a walk started by Walker::walk_async.
+ *
+ * \note Destroying the handle before calling wait() also waits for the walk, but exceptions are then lost.
+ */
+template <class GridLayerImp>
+class Walker<GridLayerImp>::AsyncWalk
+{
+public:
+  AsyncWalk(AsyncWalk&& other)
+    : walker_(other.walker_)
+    , traversal_(std::move(other.traversal_))
+    , thread_(std::move(other.thread_))
+#if HAVE_TBB
+    , task_group_(std::move(other.task_group_))
+#endif
+  {
+    other.walker_ = nullptr;
+  }
+
+  AsyncWalk(const AsyncWalk& other) = delete;
+
+  ~AsyncWalk()
+  {
+    if (walker_) {
+      try {
+        wait();
+      } catch (...) {
+      }
+    }
+  }
+
+  //! Whether the traversal is finished, wait() still has to be called to finalize the functors.
+  bool ready() const
+  {
+    return !walker_ || traversal_.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+  }
+
+  /**
+   * \brief Waits for the traversal and finalizes the functors on the calling thread.
+   *
+   * Rethrows any exception thrown during the traversal, the functors are then not finalized (but removed from the
+   * walker, as after each walk).
+   */
+  void wait()
+  {
+    if (!walker_)
+      DUNE_THROW(Common::Exceptions::you_are_using_this_wrong, "wait() may only be called once!");
+    auto& walker = *walker_;
+    walker_ = nullptr;
+    finish_traversal();
+    try {
+      traversal_.get();
+    } catch (...) {
+      walker.clear();
+      throw;
+    }
+    walker.end_walk();
+  } // ... wait(...)
+
+private:
+  friend class Walker<GridLayerImp>;
+
+  AsyncWalk(Walker<GridLayerImp>& walker, std::function<void()> traverse, const bool use_tbb)
+    : walker_(&walker)
+  {
+    std::packaged_task<void()> traversal(std::move(traverse));
+    traversal_ = traversal.get_future();
+#if HAVE_TBB
+    if (use_tbb) {
+      auto shared_traversal = std::make_shared<std::packaged_task<void()>>(std::move(traversal));
+      task_group_ = Common::make_unique<tbb::task_group>();
+      task_group_->run([shared_traversal] { (*shared_traversal)(); });
+      return;
+    }
+#endif
+    thread_ = std::thread(std::move(traversal));
+  }
+
+  //! Waits for the traversal, discards its result and removes the functors from the walker without finalizing them.
+  void cancel()
+  {
+    auto& walker = *walker_;
+    walker_ = nullptr;
+    finish_traversal();
+    walker.clear();
+  }
+
+  void finish_traversal()
+  {
+#if HAVE_TBB
+    if (task_group_)
+      task_group_->wait();
+#endif
+    if (thread_.joinable())
+      thread_.join();
+  }
+
+  Walker<GridLayerImp>* walker_;
+  std::future<void> traversal_;
+  std::thread thread_;
+#if HAVE_TBB
+  std::unique_ptr<tbb::task_group> task_group_;
+#endif
+}; // class Walker::AsyncWalk
+
+
 } // namespace Grid
 } // namespace XT
 } // namespace Dune
@@ -12,9 +12,14 @@
 #ifndef DUNE_XT_GRID_WALKER_APPLY_ON_HH
 #define DUNE_XT_GRID_WALKER_APPLY_ON_HH
 
+#include <algorithm>
 #include <functional>
+#include <memory>
+#include <type_traits>
+#include <vector>
 
 #include <dune/grid/common/partitionset.hh>
+#include <dune/grid/common/rangegenerators.hh>
 
 #include <dune/xt/common/memory.hh>
 
@@ -137,6 +142,17 @@ public:
 
   virtual bool apply_on(const GridLayerType& /*grid_layer*/, const IntersectionType& /*intersection*/) const = 0;
 
+  /**
+   * \brief Whether this filter selects all inner intersections, each from exactly one side, and nothing else.
+   *
+   * If a walker visits each inner intersection only once anyway, it may then skip this filter for those, \sa
+   * Walker::visit_inner_intersections_once.
+   */
+  virtual bool selects_inner_intersections_once() const
+  {
+    return false;
+  }
+
   WhichIntersection<GridLayerType>* operator!() const
   {
     return new internal::NegatedIntersectionFilter<GridLayerType>(*this);
@@ -381,6 +397,11 @@ public:
     } else
       return false;
   }
+
+  virtual bool selects_inner_intersections_once() const override final
+  {
+    return std::is_same<PartitionSetType, Dune::Partitions::All>::value;
+  }
 }; // class InnerIntersectionsPrimally
 
 
@@ -685,6 +706,146 @@ public:
     return PartitionSetType::contains(entity.partitionType());
   }
 }; // class PartitionSetEntities
+
+
+/**
+ *  \brief Selects the entities selected by the given filter, which is evaluated only once on construction.
+ *
+ *  The result is stored in a bitmask indexed by the index set of the grid layer, so that repeated walks only cost an
+ *  index lookup and a bit test per entity. Copies share the bitmask, so pass mask.copy() to each Walker::append.
+ *
+ *  \note Only valid as long as the grid layer did not change, call update() otherwise.
+ */
+template <class GridLayerImp>
+class EntityMask final : public WhichEntity<GridLayerImp>
+{
+  typedef WhichEntity<GridLayerImp> BaseType;
+
+public:
+  using typename BaseType::GridLayerType;
+  typedef typename BaseType::EntityType EntityType;
+
+  EntityMask(const GridLayerType& grid_layer, const BaseType& filter)
+  {
+    update(grid_layer, filter);
+  }
+
+  //! Evaluates the filter again, copies made before keep their bitmask.
+  void update(const GridLayerType& grid_layer, const BaseType& filter)
+  {
+    const auto& index_set = grid_layer.indexSet();
+    auto mask = std::make_shared<std::vector<bool>>(index_set.size(0), false);
+    for (auto&& element : elements(grid_layer))
+      (*mask)[index_set.index(element)] = filter.apply_on(grid_layer, element);
+    mask_ = mask;
+  }
+
+  virtual WhichEntity<GridLayerImp>* copy() const override final
+  {
+    return new EntityMask<GridLayerImp>(*this);
+  }
+
+  virtual bool apply_on(const GridLayerType& grid_layer, const EntityType& entity) const override final
+  {
+    return (*mask_)[grid_layer.indexSet().index(entity)];
+  }
+
+private:
+  std::shared_ptr<const std::vector<bool>> mask_;
+}; // class EntityMask
+
+
+/**
+ *  \brief Selects the intersections selected by the given filter, which is evaluated only once on construction.
+ *
+ *  The result is stored in a mask indexed by the index of the inside element (w.r.t. the index set of the grid layer)
+ *  and the local index of the intersection (indexInInside). The Walker passes the index of the inside element, so
+ *  that repeated walks only cost a lookup in the mask per intersection. Copies share the mask, so pass mask.copy() to
+ *  each Walker::append.
+ *
+ *  \note Only valid as long as the grid layer did not change, call update() otherwise.
+ *  \note On nonconforming grid layers, several intersections may share the same indexInInside. If the filter does not
+ *        select all or none of them, the filter is evaluated again for these intersections during the walk.
+ */
+template <class GridLayerImp>
+class IntersectionMask final : public WhichIntersection<GridLayerImp>
+{
+  typedef WhichIntersection<GridLayerImp> BaseType;
+
+  enum : unsigned char
+  {
+    unset,
+    rejected,
+    selected,
+    ambiguous
+  };
+
+public:
+  using typename BaseType::GridLayerType;
+  using typename BaseType::IntersectionType;
+
+  IntersectionMask(const GridLayerType& grid_layer, const BaseType& filter)
+  {
+    update(grid_layer, filter);
+  }
+
+  //! Evaluates the filter again, copies made before keep their mask.
+  void update(const GridLayerType& grid_layer, const BaseType& filter)
+  {
+    const auto& index_set = grid_layer.indexSet();
+    filter_ = std::shared_ptr<const BaseType>(filter.copy());
+    selects_inner_intersections_once_ = filter.selects_inner_intersections_once();
+    max_faces_ = 0;
+    for (auto&& element : elements(grid_layer))
+      max_faces_ = std::max(max_faces_, size_t(element.subEntities(1)));
+    auto mask = std::make_shared<std::vector<unsigned char>>(index_set.size(0) * max_faces_, unset);
+    for (auto&& element : elements(grid_layer)) {
+      const size_t offset = index_set.index(element) * max_faces_;
+      const auto intersection_it_end = grid_layer.iend(element);
+      for (auto intersection_it = grid_layer.ibegin(element); intersection_it != intersection_it_end;
+           ++intersection_it) {
+        const auto& intersection = *intersection_it;
+        auto& value = (*mask)[offset + intersection.indexInInside()];
+        const unsigned char result = filter.apply_on(grid_layer, intersection) ? selected : rejected;
+        value = (value == unset || value == result) ? result : static_cast<unsigned char>(ambiguous);
+      }
+    }
+    mask_ = mask;
+  } // ... update(...)
+
+  virtual WhichIntersection<GridLayerImp>* copy() const override final
+  {
+    return new IntersectionMask<GridLayerImp>(*this);
+  }
+
+  //! Creates the inside element to obtain its index, prefer apply_on(grid_layer, intersection, inside_index).
+  virtual bool apply_on(const GridLayerType& grid_layer, const IntersectionType& intersection) const override final
+  {
+    return apply_on(grid_layer, intersection, grid_layer.indexSet().index(intersection.inside()));
+  }
+
+  //! \param inside_index index of the inside element w.r.t. the index set of the grid layer
+  bool apply_on(const GridLayerType& grid_layer, const IntersectionType& intersection, const size_t inside_index) const
+  {
+    const auto value = (*mask_)[inside_index * max_faces_ + intersection.indexInInside()];
+    if (value == ambiguous)
+      return filter_->apply_on(grid_layer, intersection);
+    return value == selected;
+  }
+
+  virtual bool selects_inner_intersections_once() const override final
+  {
+    return selects_inner_intersections_once_;
+  }
+
+private:
+  std::shared_ptr<const BaseType> filter_;
+  bool selects_inner_intersections_once_;
+  size_t max_faces_;
+  std::shared_ptr<const std::vector<unsigned char>> mask_;
+}; // class IntersectionMask
+
+
 } // namespace ApplyOn
 } // namespace Grid
 } // namespace XT
@@ -0,0 +1,192 @@
+// This file is part of the dune-xt-grid project:
+//   https://github.com/dune-community/dune-xt-grid
+// Copyright 2009-2018 dune-xt-grid developers and contributors. All rights reserved.
+// License: Dual licensed as BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+//      or  GPL-2.0+ (http://opensource.org/licenses/gpl-license)
+//          with "runtime exception" (http://www.dune-project.org/license.html)
+
+#ifndef DUNE_XT_GRID_WALKER_BATCH_HH
+#define DUNE_XT_GRID_WALKER_BATCH_HH
+
+#include <array>
+#include <cstddef>
+
+#include <dune/xt/common/exceptions.hh>
+#include <dune/xt/grid/entity.hh>
+#include <dune/xt/grid/type_traits.hh>
+
+namespace Dune {
+namespace XT {
+namespace Grid {
+
+
+/**
+ * \brief A batch of up to batch_size elements together with their gathered geometry data, \sa Functor::Codim0Batch.
+ *
+ * The geometry data is stored lane-wise (one std::array entry per element of the batch, structure of arrays), so that
+ * kernels may process all elements of a batch at once using SIMD instructions. The lanes of a partially filled batch
+ * beyond size() are padded with the data of the last element, so kernels may always process all batch_size lanes and
+ * only have to discard the results of the padded lanes.
+ *
+ * Jacobians and integration elements are evaluated at the center of the reference element, which is exact for affine
+ * geometries (i.e. simplices and parallelepipeds). Up to 2^dim corners are stored per element.
+ */
+template <class GridLayerImp, size_t batch_size>
+class ElementBatch
+{
+  static_assert(batch_size > 0, "");
+
+public:
+  typedef GridLayerImp GridLayerType;
+  using EntityType = extract_entity_t<GridLayerType>;
+  typedef typename EntityType::Geometry GeometryType;
+  typedef typename GeometryType::ctype ctype;
+  static const constexpr size_t lanes = batch_size;
+  static const constexpr size_t dimDomain = GeometryType::mydimension;
+  static const constexpr size_t dimWorld = GeometryType::coorddimension;
+  static const constexpr size_t max_corners = size_t(1) << dimDomain;
+  //! One value per element of the batch.
+  typedef std::array<ctype, batch_size> LaneType;
+
+  ElementBatch()
+    : size_(0)
+  {
+  }
+
+  size_t size() const
+  {
+    return size_;
+  }
+
+  bool empty() const
+  {
+    return size_ == 0;
+  }
+
+  bool full() const
+  {
+    return size_ == batch_size;
+  }
+
+  const EntityType& element(const size_t lane) const
+  {
+    return elements_[lane];
+  }
+
+  //! Index of the element w.r.t. the index set of the grid layer.
+  size_t index(const size_t lane) const
+  {
+    return indices_[lane];
+  }
+
+  size_t corners(const size_t lane) const
+  {
+    return num_corners_[lane];
+  }
+
+  //! The ii-th coordinate of the cc-th corner.
+  const LaneType& corner(const size_t cc, const size_t ii) const
+  {
+    return corners_[cc][ii];
+  }
+
+  const LaneType& volumes() const
+  {
+    return volumes_;
+  }
+
+  const LaneType& integration_elements() const
+  {
+    return integration_elements_;
+  }
+
+  //! The (ii, jj)-th entry of the transposed inverse Jacobian.
+  const LaneType& jacobian_inverse_transposed(const size_t ii, const size_t jj) const
+  {
+    return jacobian_inverse_transposed_[ii][jj];
+  }
+
+  //! Gathers the geometry data of the given element into the next lane.
+  void push_back(const EntityType& element, const size_t index)
+  {
+    if (full())
+      DUNE_THROW(Common::Exceptions::you_are_using_this_wrong, "The batch is full, size() = " << size_);
+    const auto geometry = element.geometry();
+    const size_t lane = size_;
+    elements_[lane] = element;
+    indices_[lane] = index;
+    const size_t num_corners = geometry.corners();
+    if (num_corners > max_corners)
+      DUNE_THROW(Common::Exceptions::internal_error,
+                 "Elements with more than " << max_corners << " corners are not supported!");
+    num_corners_[lane] = num_corners;
+    for (size_t cc = 0; cc < num_corners; ++cc) {
+      const auto corner = geometry.corner(cc);
+      for (size_t ii = 0; ii < dimWorld; ++ii)
+        corners_[cc][ii][lane] = corner[ii];
+    }
+    volumes_[lane] = geometry.volume();
+    const auto& local_center = reference_element(geometry).position(0, 0);
+    integration_elements_[lane] = geometry.integrationElement(local_center);
+    const auto jacobian_inverse_transposed = geometry.jacobianInverseTransposed(local_center);
+    for (size_t ii = 0; ii < dimWorld; ++ii)
+      for (size_t jj = 0; jj < dimDomain; ++jj)
+        jacobian_inverse_transposed_[ii][jj][lane] = jacobian_inverse_transposed[ii][jj];
+    ++size_;
+  } // ... push_back(...)
+
+  //! Pads the unused lanes with the data of the last element, \sa ElementBatch.
+  void pad()
+  {
+    if (empty())
+      return;
+    const size_t last = size_ - 1;
+    for (size_t lane = size_; lane < batch_size; ++lane) {
+      elements_[lane] = elements_[last];
+      indices_[lane] = indices_[last];
+      num_corners_[lane] = num_corners_[last];
+      for (size_t cc = 0; cc < max_corners; ++cc)
+        for (size_t ii = 0; ii < dimWorld; ++ii)
+          corners_[cc][ii][lane] = corners_[cc][ii][last];
+      volumes_[lane] = volumes_[last];
+      integration_elements_[lane] = integration_elements_[last];
+      for (size_t ii = 0; ii < dimWorld; ++ii)
+        for (size_t jj = 0; jj < dimDomain; ++jj)
+          jacobian_inverse_transposed_[ii][jj][lane] = jacobian_inverse_transposed_[ii][jj][last];
+    }
+  } // ... pad(...)
+
+  void clear()
+  {
+    size_ = 0;
+  }
+
+private:
+  size_t size_;
+  std::array<EntityType, batch_size> elements_;
+  std::array<size_t, batch_size> indices_;
+  std::array<size_t, batch_size> num_corners_;
+  std::array<std::array<LaneType, dimWorld>, max_corners> corners_;
+  LaneType volumes_;
+  LaneType integration_elements_;
+  std::array<std::array<LaneType, dimDomain>, dimWorld> jacobian_inverse_transposed_;
+}; // class ElementBatch
+
+template <class GL, size_t b>
+const constexpr size_t ElementBatch<GL, b>::lanes;
+
+template <class GL, size_t b>
+const constexpr size_t ElementBatch<GL, b>::dimDomain;
+
+template <class GL, size_t b>
+const constexpr size_t ElementBatch<GL, b>::dimWorld;
+
+template <class GL, size_t b>
+const constexpr size_t ElementBatch<GL, b>::max_corners;
+
+
+} // namespace Grid
+} // namespace XT
+} // namespace Dune
+
+#endif // DUNE_XT_GRID_WALKER_BATCH_HH
@@ -0,0 +1,94 @@
+// This file is part of the dune-xt-grid project:
+//   https://github.com/dune-community/dune-xt-grid
+// Copyright 2009-2018 dune-xt-grid developers and contributors. All rights reserved.
+// License: Dual licensed as BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+//      or  GPL-2.0+ (http://opensource.org/licenses/gpl-license)
+//          with "runtime exception" (http://www.dune-project.org/license.html)
+
+#ifndef DUNE_XT_GRID_WALKER_FINGERPRINT_HH
+#define DUNE_XT_GRID_WALKER_FINGERPRINT_HH
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dune/xt/grid/type_traits.hh>
+
+namespace Dune {
+namespace XT {
+namespace Grid {
+namespace internal {
+
+
+//! Whether the grid provides a sequence number by sequence(), which changes with each adaptation.
+template <class GridType, class = void>
+struct has_sequence : public std::false_type
+{
+};
+
+template <class GridType>
+struct has_sequence<GridType, decltype(void(std::declval<const GridType&>().sequence()))> : public std::true_type
+{
+};
+
+
+/**
+ * \brief Identifies the state of a grid layer for data computed from it, \sa WalkPlan and GeometryCache.
+ *
+ * Consists of the number of elements and vertices of the grid layer, the number of elements on each level of the
+ * grid and, if the grid provides one, its sequence number. Only in the latter case, every adaptation of the grid is
+ * detected (exact is true), otherwise adaptations which preserve all these numbers go unnoticed.
+ */
+template <class GridLayerType>
+class GridLayerFingerprint
+{
+  typedef extract_grid_t<GridLayerType> GridType;
+
+public:
+  static const constexpr bool exact = has_sequence<GridType>::value;
+
+  GridLayerFingerprint() = default;
+
+  explicit GridLayerFingerprint(const GridLayerType& grid_layer)
+  {
+    values_.push_back(grid_layer.size(0));
+    values_.push_back(grid_layer.size(GridLayerType::dimension));
+    const auto& grid = grid_layer.grid();
+    for (int level = 0; level <= grid.maxLevel(); ++level)
+      values_.push_back(grid.size(level, 0));
+    append_sequence(grid, std::integral_constant<bool, exact>());
+  }
+
+  bool operator==(const GridLayerFingerprint& other) const
+  {
+    return values_ == other.values_;
+  }
+
+  bool operator!=(const GridLayerFingerprint& other) const
+  {
+    return values_ != other.values_;
+  }
+
+private:
+  void append_sequence(const GridType& grid, std::true_type)
+  {
+    values_.push_back(grid.sequence());
+  }
+
+  void append_sequence(const GridType& /*grid*/, std::false_type)
+  {
+  }
+
+  std::vector<size_t> values_;
+}; // class GridLayerFingerprint
+
+template <class GL>
+const constexpr bool GridLayerFingerprint<GL>::exact;
+
+
+} // namespace internal
+} // namespace Grid
+} // namespace XT
+} // namespace Dune
+
+#endif // DUNE_XT_GRID_WALKER_FINGERPRINT_HH
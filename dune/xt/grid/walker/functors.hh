@@ -11,15 +11,27 @@
 #ifndef DUNE_XT_GRID_WALKER_FUNCTORS_HH
 #define DUNE_XT_GRID_WALKER_FUNCTORS_HH
 
+#include <memory>
+#include <vector>
+
 #include <dune/xt/grid/boundaryinfo.hh>
 #include <dune/xt/grid/entity.hh>
 #include <dune/xt/grid/intersection.hh>
+#include <dune/xt/grid/walker/batch.hh>
 
 namespace Dune {
 namespace XT {
 namespace Grid {
 namespace Functor {
 
+/**
+ *  \brief Interface for functors to be applied on all elements of a grid layer, \sa Walker.
+ *
+ *  In a parallel walk (\sa Walker::walk), each thread works on its own copy of a functor if copy() returns a copy.
+ *  Those copies are created after prepare() has been called on this functor and are handed back to this functor by
+ *  join() before finalize() is called, they are never prepared or finalized themselves. If copy() returns nullptr
+ *  (the default), the functor is shared among all threads and apply_local() needs to be thread safe.
+ */
 template <class GridLayerImp>
 class Codim0
 {
@@ -40,6 +52,22 @@ public:
   virtual void finalize()
   {
   }
+
+  /**
+   * \brief Returns a thread local copy of this functor (ownership is transferred), or nullptr if it may be shared.
+   * \note  May be called concurrently to apply_local(), so only the configuration should be copied, not the state.
+   */
+  virtual Codim0<GridLayerImp>* copy()
+  {
+    return nullptr;
+  }
+
+  /**
+   * \brief Merges the state of a copy (obtained by copy() on this functor or on one of its copies) into this functor.
+   */
+  virtual void join(Codim0<GridLayerImp>& /*other*/)
+  {
+  }
 }; // class Codim0
 
 template <class GridLayerImp, class ReturnImp>
@@ -60,6 +88,145 @@ public:
   virtual ReturnType result() const = 0;
 }; // class Codim0ReturnFunctor
 
+/**
+ * \brief Reduces the local results of compute_locally() over all elements (by default by summation).
+ *
+ * Derived classes have to implement compute_locally() and copy(), the latter as
+\code
+virtual Codim0<GridLayerType>* copy() override
+{
+  return new Derived(*this);
+}
+\endcode
+ * The copy constructor of this class does not copy the accumulated state, the partial results of all copies are
+ * combined by join(). If deterministic, the local results are stored by element index and summed pairwise in
+ * finalize(), so that the result does not depend on the number of threads or the partitioning.
+ */
+template <class GridLayerImp, class ResultImp = double>
+class Codim0Reduction : public Codim0Return<GridLayerImp, ResultImp>
+{
+  typedef Codim0Return<GridLayerImp, ResultImp> BaseType;
+  typedef Codim0Reduction<GridLayerImp, ResultImp> ThisType;
+
+public:
+  using typename BaseType::GridLayerType;
+  using typename BaseType::EntityType;
+  using typename BaseType::ReturnType;
+
+  explicit Codim0Reduction(const ReturnType& neutral = ReturnType(0))
+    : grid_layer_(nullptr)
+    , deterministic_(false)
+    , neutral_(neutral)
+    , result_(neutral)
+  {
+  }
+
+  //! \note The grid layer is only used to obtain the element indices if deterministic and has to outlive this.
+  Codim0Reduction(const GridLayerType& grid_layer, const bool deterministic, const ReturnType& neutral = ReturnType(0))
+    : grid_layer_(&grid_layer)
+    , deterministic_(deterministic)
+    , neutral_(neutral)
+    , result_(neutral)
+  {
+  }
+
+  //! Copies the configuration, not the accumulated state, \sa Codim0::copy.
+  Codim0Reduction(const ThisType& other)
+    : BaseType(other)
+    , grid_layer_(other.grid_layer_)
+    , deterministic_(other.deterministic_)
+    , neutral_(other.neutral_)
+    , result_(other.neutral_)
+    , local_results_(other.local_results_)
+  {
+  }
+
+  virtual ~Codim0Reduction()
+  {
+  }
+
+  /**
+   * \brief Has to return a copy of the derived class, which is never shared between threads.
+   * \note  Not provided, since a copy of this base alone would silently lose the derived state and a shared functor
+   *        would race on the accumulated result.
+   */
+  virtual Codim0<GridLayerType>* copy() override = 0;
+
+  virtual void prepare() override
+  {
+    result_ = neutral_;
+    if (deterministic_)
+      local_results_ = std::make_shared<std::vector<ReturnType>>(grid_layer_->indexSet().size(0), neutral_);
+  }
+
+  virtual void apply_local(const EntityType& entity) override
+  {
+    if (deterministic_)
+      (*local_results_)[grid_layer_->indexSet().index(entity)] = this->compute_locally(entity);
+    else
+      combine(result_, this->compute_locally(entity));
+  }
+
+  virtual void join(Codim0<GridLayerType>& other) override
+  {
+    if (!deterministic_)
+      combine(result_, dynamic_cast<ThisType&>(other).result_);
+  }
+
+  virtual void finalize() override
+  {
+    if (deterministic_) {
+      result_ = pairwise_combine(*local_results_, 0, local_results_->size());
+      local_results_ = nullptr;
+    }
+  }
+
+  virtual ReturnType result() const override
+  {
+    return result_;
+  }
+
+protected:
+  //! Has to be associative (and commutative, if not deterministic).
+  virtual void combine(ReturnType& accumulated, const ReturnType& local_result) const
+  {
+    accumulated += local_result;
+  }
+
+private:
+  ReturnType pairwise_combine(const std::vector<ReturnType>& values, const size_t first, const size_t last) const
+  {
+    if (last - first == 0)
+      return neutral_;
+    if (last - first == 1)
+      return values[first];
+    const size_t middle = first + (last - first) / 2;
+    auto ret = pairwise_combine(values, first, middle);
+    combine(ret, pairwise_combine(values, middle, last));
+    return ret;
+  }
+
+  const GridLayerType* grid_layer_;
+  const bool deterministic_;
+  const ReturnType neutral_;
+  ReturnType result_;
+  std::shared_ptr<std::vector<ReturnType>> local_results_;
+}; // class Codim0Reduction
+
+/**
+ * \brief Indices passed to indexed codim 1 lambdas, \sa Walker::append_indexed
+ *
+ * The element indices are w.r.t. the index set of the grid layer. For intersections without neighbor, outside equals
+ * inside and index_in_outside is -1 (just as the inside element is passed as outside element to Codim1 functors).
+ */
+struct IntersectionIndices
+{
+  size_t inside;
+  size_t outside;
+  int index_in_inside;
+  int index_in_outside;
+};
+
 template <class GridLayerImp>
 class Codim1
 {
@@ -83,6 +250,22 @@ public:
   virtual void finalize()
   {
   }
+
+  /**
+   * \brief Returns a thread local copy of this functor (ownership is transferred), or nullptr if it may be shared.
+   * \sa    Codim0
+   */
+  virtual Codim1<GridLayerImp>* copy()
+  {
+    return nullptr;
+  }
+
+  /**
+   * \brief Merges the state of a copy (obtained by copy() on this functor or on one of its copies) into this functor.
+   */
+  virtual void join(Codim1<GridLayerImp>& /*other*/)
+  {
+  }
 }; // class Codim1
 
 template <class GridLayerImp>
@@ -110,8 +293,143 @@ public:
   virtual void finalize()
   {
   }
+
+  /**
+   * \brief Returns a thread local copy of this functor (ownership is transferred), or nullptr if it may be shared.
+   * \note  The Walker requests a single copy for the codim 0 and the codim 1 part, which is joined once.
+   * \sa    Codim0
+   */
+  virtual Codim0And1<GridLayerImp>* copy()
+  {
+    return nullptr;
+  }
+
+  /**
+   * \brief Merges the state of a copy (obtained by copy() on this functor or on one of its copies) into this functor.
+   */
+  virtual void join(Codim0And1<GridLayerImp>& /*other*/)
+  {
+  }
 }; // class Codim0And1
 
+/**
+ * \brief Interface for functors to be applied once on each sub-entity of the given codimension, \sa Walker.
+ *
+ * Each sub-entity is visited together with one of the elements containing it (the first one visited) and its local
+ * index within this element. The semantics of copy() and join() are the same as for Codim0.
+ *
+ * \note Requires the index set of the grid layer to provide indices for the given codimension.
+ */
+template <class GridLayerImp, size_t codim>
+class CodimN
+{
+public:
+  typedef GridLayerImp GridLayerType;
+  using EntityType = extract_entity_t<GridLayerType>;
+  using SubEntityType = extract_entity_t<GridLayerType, codim>;
+  static const constexpr size_t codimension = codim;
+
+  virtual ~CodimN()
+  {
+  }
+
+  virtual void prepare()
+  {
+  }
+
+  virtual void apply_local(const SubEntityType& sub_entity, const EntityType& element, const size_t local_index) = 0;
+
+  virtual void finalize()
+  {
+  }
+
+  virtual CodimN<GridLayerImp, codim>* copy()
+  {
+    return nullptr;
+  }
+
+  virtual void join(CodimN<GridLayerImp, codim>& /*other*/)
+  {
+  }
+}; // class CodimN
+
+/**
+ * \brief Interface for functors to be applied on batches of elements with gathered geometry data, \sa ElementBatch.
+ *
+ * The walker collects the elements (selected by the ApplyOn filter) in batches of batch_size elements, the last batch
+ * of each thread may be smaller. The semantics of copy() and join() are the same as for Codim0.
+ *
+ * \note The elements of a batch may stem from different colors in Walker::walk_colored.
+ */
+template <class GridLayerImp, size_t batch_size = 8>
+class Codim0Batch
+{
+public:
+  typedef GridLayerImp GridLayerType;
+  using EntityType = extract_entity_t<GridLayerType>;
+  typedef ElementBatch<GridLayerType, batch_size> BatchType;
+
+  virtual ~Codim0Batch()
+  {
+  }
+
+  virtual void prepare()
+  {
+  }
+
+  virtual void apply_local(const BatchType& batch) = 0;
+
+  virtual void finalize()
+  {
+  }
+
+  virtual Codim0Batch<GridLayerImp, batch_size>* copy()
+  {
+    return nullptr;
+  }
+
+  virtual void join(Codim0Batch<GridLayerImp, batch_size>& /*other*/)
+  {
+  }
+}; // class Codim0Batch
+
+/**
+ * \brief Interface for functors to be applied on all father-child pairs of the grid hierarchy below the elements of a
+ *        grid layer, \sa HierarchicWalker.
+ *
+ * The semantics of copy() and join() are the same as for Codim0.
+ */
+template <class GridLayerImp>
+class FatherChild
+{
+public:
+  typedef GridLayerImp GridLayerType;
+  using EntityType = extract_entity_t<GridLayerType>;
+
+  virtual ~FatherChild()
+  {
+  }
+
+  virtual void prepare()
+  {
+  }
+
+  virtual void apply_local(const EntityType& father, const EntityType& child) = 0;
+
+  virtual void finalize()
+  {
+  }
+
+  virtual FatherChild<GridLayerImp>* copy()
+  {
+    return nullptr;
+  }
+
+  virtual void join(FatherChild<GridLayerImp>& /*other*/)
+  {
+  }
+}; // class FatherChild
+
 template <class GridLayerImp>
 class DirichletDetector : public Codim1<GridLayerImp>
 {
@@ -140,6 +458,16 @@ public:
       ++found_;
   }
 
+  virtual BaseType* copy() override
+  {
+    return new DirichletDetector<GridLayerImp>(boundary_info_);
+  }
+
+  virtual void join(BaseType& other) override
+  {
+    found_ += dynamic_cast<DirichletDetector<GridLayerImp>&>(other).found_;
+  }
+
   bool found() const
   {
     return found_ > 0;
@@ -0,0 +1,198 @@
+// This file is part of the dune-xt-grid project:
+//   https://github.com/dune-community/dune-xt-grid
+// Copyright 2009-2018 dune-xt-grid developers and contributors. All rights reserved.
+// License: Dual licensed as BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+//      or  GPL-2.0+ (http://opensource.org/licenses/gpl-license)
+//          with "runtime exception" (http://www.dune-project.org/license.html)
+
+#ifndef DUNE_XT_GRID_WALKER_GEOMETRY_CACHE_HH
+#define DUNE_XT_GRID_WALKER_GEOMETRY_CACHE_HH
+
+#include <array>
+#include <vector>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+
+#include <dune/grid/common/rangegenerators.hh>
+
+#include <dune/xt/grid/entity.hh>
+#include <dune/xt/grid/type_traits.hh>
+#include <dune/xt/grid/walker/fingerprint.hh>
+
+namespace Dune {
+namespace XT {
+namespace Grid {
+
+
+/**
+ * \brief Geometry data of all elements of a grid layer, computed once and shared by all functors of a walk.
+ *
+ * Stores centers, volumes, diameters (the maximum distance of two corners, \sa entity_diameter), integration elements
+ * and transposed inverse Jacobians of all elements as structure of arrays, indexed by the index set of the grid layer.
+ * Integration elements and Jacobians are evaluated at the center of the reference element, which is exact for affine
+ * geometries.
+ *
+ * \note The cache is considered valid() as long as the fingerprint of the grid layer did not change, \sa
+ *       internal::GridLayerFingerprint. This detects each adaptation of grids providing a sequence number (i.e. if
+ *       exact is true), call update() or invalidate() after each adaptation of other grids.
+ * \sa   Walker::use_geometry_cache
+ */
+template <class GridLayerImp>
+class GeometryCache
+{
+  static_assert(is_layer<GridLayerImp>::value, "");
+
+public:
+  typedef GridLayerImp GridLayerType;
+  using EntityType = extract_entity_t<GridLayerType>;
+  typedef typename EntityType::Geometry GeometryType;
+  typedef typename GeometryType::ctype ctype;
+  static const constexpr size_t dimDomain = GeometryType::mydimension;
+  static const constexpr size_t dimWorld = GeometryType::coorddimension;
+  typedef FieldVector<ctype, dimWorld> DomainType;
+  typedef FieldMatrix<ctype, dimWorld, dimDomain> JacobianInverseTransposedType;
+
+  //! Whether each adaptation of the grid is detected by valid(), \sa internal::GridLayerFingerprint.
+  static const constexpr bool exact = internal::GridLayerFingerprint<GridLayerType>::exact;
+
+  explicit GeometryCache(const GridLayerType& grid_layer)
+    : grid_layer_(grid_layer)
+    , valid_(false)
+  {
+    update();
+  }
+
+  const GridLayerType& grid_layer() const
+  {
+    return grid_layer_;
+  }
+
+  bool valid() const
+  {
+    return valid_ && fingerprint_ == internal::GridLayerFingerprint<GridLayerType>(grid_layer_);
+  }
+
+  void invalidate()
+  {
+    valid_ = false;
+  }
+
+  void update()
+  {
+    const auto& index_set = grid_layer_.indexSet();
+    const size_t num_indices = index_set.size(0);
+    for (auto& coordinates : centers_)
+      coordinates.assign(num_indices, 0.);
+    volumes_.assign(num_indices, 0.);
+    diameters_.assign(num_indices, 0.);
+    integration_elements_.assign(num_indices, 0.);
+    for (auto& row : jacobian_inverse_transposed_)
+      for (auto& entries : row)
+        entries.assign(num_indices, 0.);
+    for (auto&& element : elements(grid_layer_)) {
+      const size_t index = index_set.index(element);
+      const auto geometry = element.geometry();
+      const auto center = geometry.center();
+      for (size_t ii = 0; ii < dimWorld; ++ii)
+        centers_[ii][index] = center[ii];
+      volumes_[index] = geometry.volume();
+      diameters_[index] = entity_diameter(element);
+      const auto& local_center = reference_element(geometry).position(0, 0);
+      integration_elements_[index] = geometry.integrationElement(local_center);
+      const auto jacobian_inverse_transposed = geometry.jacobianInverseTransposed(local_center);
+      for (size_t ii = 0; ii < dimWorld; ++ii)
+        for (size_t jj = 0; jj < dimDomain; ++jj)
+          jacobian_inverse_transposed_[ii][jj][index] = jacobian_inverse_transposed[ii][jj];
+    }
+    fingerprint_ = internal::GridLayerFingerprint<GridLayerType>(grid_layer_);
+    valid_ = true;
+  } // ... update(...)
+
+  DomainType center(const EntityType& element) const
+  {
+    const size_t index = grid_layer_.indexSet().index(element);
+    DomainType ret;
+    for (size_t ii = 0; ii < dimWorld; ++ii)
+      ret[ii] = centers_[ii][index];
+    return ret;
+  }
+
+  ctype volume(const EntityType& element) const
+  {
+    return volumes_[grid_layer_.indexSet().index(element)];
+  }
+
+  ctype diameter(const EntityType& element) const
+  {
+    return diameters_[grid_layer_.indexSet().index(element)];
+  }
+
+  ctype integration_element(const EntityType& element) const
+  {
+    return integration_elements_[grid_layer_.indexSet().index(element)];
+  }
+
+  JacobianInverseTransposedType jacobian_inverse_transposed(const EntityType& element) const
+  {
+    const size_t index = grid_layer_.indexSet().index(element);
+    JacobianInverseTransposedType ret;
+    for (size_t ii = 0; ii < dimWorld; ++ii)
+      for (size_t jj = 0; jj < dimDomain; ++jj)
+        ret[ii][jj] = jacobian_inverse_transposed_[ii][jj][index];
+    return ret;
+  }
+
+  //! The ii-th coordinate of the centers of all elements, indexed by the index set.
+  const std::vector<ctype>& centers(const size_t ii) const
+  {
+    return centers_[ii];
+  }
+
+  const std::vector<ctype>& volumes() const
+  {
+    return volumes_;
+  }
+
+  const std::vector<ctype>& diameters() const
+  {
+    return diameters_;
+  }
+
+  const std::vector<ctype>& integration_elements() const
+  {
+    return integration_elements_;
+  }
+
+  //! The (ii, jj)-th entry of the transposed inverse Jacobians of all elements, indexed by the index set.
+  const std::vector<ctype>& jacobians_inverse_transposed(const size_t ii, const size_t jj) const
+  {
+    return jacobian_inverse_transposed_[ii][jj];
+  }
+
+private:
+  const GridLayerType grid_layer_;
+  internal::GridLayerFingerprint<GridLayerType> fingerprint_;
+  bool valid_;
+  std::array<std::vector<ctype>, dimWorld> centers_;
+  std::vector<ctype> volumes_;
+  std::vector<ctype> diameters_;
+  std::vector<ctype> integration_elements_;
+  std::array<std::array<std::vector<ctype>, dimDomain>, dimWorld> jacobian_inverse_transposed_;
+}; // class GeometryCache
+
+template <class GL>
+const constexpr size_t GeometryCache<GL>::dimDomain;
+
+template <class GL>
+const constexpr size_t GeometryCache<GL>::dimWorld;
+
+template <class GL>
+const constexpr bool GeometryCache<GL>::exact;
+
+
+} // namespace Grid
+} // namespace XT
+} // namespace Dune
+
+#endif // DUNE_XT_GRID_WALKER_GEOMETRY_CACHE_HH
@@ -0,0 +1,244 @@
+// This file is part of the dune-xt-grid project:
+//   https://github.com/dune-community/dune-xt-grid
+// Copyright 2009-2018 dune-xt-grid developers and contributors. All rights reserved.
+// License: Dual licensed as BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+//      or  GPL-2.0+ (http://opensource.org/licenses/gpl-license)
+//          with "runtime exception" (http://www.dune-project.org/license.html)
+
+#ifndef DUNE_XT_GRID_WALKER_HIERARCHIC_HH
+#define DUNE_XT_GRID_WALKER_HIERARCHIC_HH
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#if HAVE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/tbb_stddef.h>
+#endif
+
+#include <dune/common/unused.hh>
+
+#include <dune/grid/common/rangegenerators.hh>
+
+#include <dune/xt/common/configuration.hh>
+#include <dune/xt/common/memory.hh>
+#include <dune/xt/common/parallel/threadmanager.hh>
+#include <dune/xt/grid/parallel/partitioning/weighted.hh>
+#include <dune/xt/grid/type_traits.hh>
+
+#include <dune/xt/grid/walker/functors.hh>
+#include <dune/xt/grid/walker/wrapper.hh>
+
+namespace Dune {
+namespace XT {
+namespace Grid {
+
+
+/**
+ * \brief Walks the grid hierarchy below the elements of a (coarse) grid layer, e.g. to assemble multigrid transfers.
+ *
+ * All appended functors are applied on each father-child pair (\sa Functor::FatherChild) below the elements of the
+ * grid layer, down to max_level. walk() visits each father before its children (as needed for prolongations),
+ * walk_fine_to_coarse() visits all children of an element before the element itself is visited as a child (as needed
+ * for restrictions).
+ *
+ * In a parallel walk, the elements of the grid layer are partitioned as in Walker::walk (weighted by the number of
+ * their descendants) and the whole subtree below an element is visited by the same thread. Functors may thus write
+ * to data associated with the fathers and children of their subtree without locking.
+ */
+template <class GridLayerImp>
+class HierarchicWalker
+{
+  static_assert(is_layer<GridLayerImp>::value, "");
+  typedef HierarchicWalker<GridLayerImp> ThisType;
+
+public:
+  typedef GridLayerImp GridLayerType;
+  using EntityType = extract_entity_t<GridLayerType>;
+
+  //! Walks down to the finest level of the grid if max_level is negative.
+  explicit HierarchicWalker(GridLayerType grid_layer, const int max_level = -1)
+    : grid_layer_(grid_layer)
+    , max_level_(max_level)
+  {
+  }
+
+  HierarchicWalker(const ThisType& other) = delete;
+  HierarchicWalker(ThisType&& source) = default;
+
+  virtual ~HierarchicWalker() = default;
+
+  const GridLayerType& grid_layer() const
+  {
+    return grid_layer_;
+  }
+
+  int max_level() const
+  {
+    return max_level_ < 0 ? grid_layer_.grid().maxLevel() : max_level_;
+  }
+
+  ThisType& append(std::function<void(const EntityType&, const EntityType&)> lambda)
+  {
+    functors_.emplace_back(new internal::FatherChildLambdaWrapper<GridLayerType>(lambda));
+    return *this;
+  }
+
+  ThisType& append(Functor::FatherChild<GridLayerType>& functor)
+  {
+    functors_.emplace_back(new internal::FatherChildFunctorWrapper<GridLayerType>(functor));
+    return *this;
+  }
+
+  void clear()
+  {
+    functors_.clear();
+  }
+
+  //! Visits each father before its children.
+  void walk(const bool use_tbb = false)
+  {
+    walk_hierarchy(use_tbb, false);
+  }
+
+  //! Visits all children of an element before the element itself is visited as a child.
+  void walk_fine_to_coarse(const bool use_tbb = false)
+  {
+    walk_hierarchy(use_tbb, true);
+  }
+
+protected:
+  void walk_hierarchy(const bool use_tbb, const bool fine_to_coarse)
+  {
+    // prepare functors
+    for (auto& functor : functors_)
+      functor->prepare();
+
+    // only do something, if we have to
+    if (functors_.size() > 0) {
+      const int max_level = this->max_level();
+#if HAVE_TBB
+      if (use_tbb) {
+        // many small chunks of (roughly) the same number of descendants, distributed among the threads by work stealing
+        const auto num_partitions =
+            DXTC_CONFIG_GET("threading.partition_factor", 8u) * XT::Common::threadManager().current_threads();
+        const WeightedPartitioning<GridLayerType> partitioning(
+            grid_layer_, num_partitions, [&](const EntityType& element) {
+              double descendants = 0.;
+              for (auto&& descendant : descendantElements(element, max_level)) {
+                DUNE_UNUSED_PARAMETER(descendant);
+                descendants += 1.;
+              }
+              return descendants;
+            });
+        tbb::blocked_range<std::size_t> range(0, partitioning.partitions());
+        Body<WeightedPartitioning<GridLayerType>> body(*this, partitioning, max_level, fine_to_coarse);
+        tbb::parallel_reduce(range, body);
+      } else {
+        for (auto&& element : elements(grid_layer_))
+          walk_subtree(element, max_level, fine_to_coarse);
+      }
+#else
+      DUNE_UNUSED_PARAMETER(use_tbb);
+      for (auto&& element : elements(grid_layer_))
+        walk_subtree(element, max_level, fine_to_coarse);
+#endif
+    }
+
+    // finalize functors
+    for (auto& functor : functors_)
+      functor->finalize();
+    clear();
+  } // ... walk_hierarchy(...)
+
+  //! Returns a walker with thread local copies of all appended functors.
+  ThisType* copy()
+  {
+    auto ret = Common::make_unique<ThisType>(grid_layer_, max_level_);
+    for (auto& functor : functors_)
+      ret->functors_.emplace_back(functor->copy());
+    return ret.release();
+  }
+
+  void join(ThisType& other)
+  {
+    for (size_t ii = 0; ii < functors_.size(); ++ii)
+      functors_[ii]->join(*other.functors_[ii]);
+  }
+
+  void walk_subtree(const EntityType& element, const int max_level, const bool fine_to_coarse)
+  {
+    if (!fine_to_coarse) {
+      // the hierarchic iterator visits the descendants depth first, i.e. each father before its children
+      for (auto&& descendant : descendantElements(element, max_level))
+        apply_local(descendant.father(), descendant);
+    } else {
+      subtree_.clear();
+      for (auto&& descendant : descendantElements(element, max_level))
+        subtree_.emplace_back(descendant);
+      for (auto it = subtree_.rbegin(); it != subtree_.rend(); ++it)
+        apply_local(it->father(), *it);
+    }
+  } // ... walk_subtree(...)
+
+  void apply_local(const EntityType& father, const EntityType& child)
+  {
+    for (auto& functor : functors_)
+      functor->apply_local(father, child);
+  }
+
+#if HAVE_TBB
+  template <class PartitioningType>
+  struct Body
+  {
+    Body(ThisType& walker, const PartitioningType& partitioning, const int max_level, const bool fine_to_coarse)
+      : walker_(walker)
+      , partitioning_(partitioning)
+      , max_level_(max_level)
+      , fine_to_coarse_(fine_to_coarse)
+    {
+    }
+
+    Body(Body& other, tbb::split /*split*/)
+      : walker_copy_(other.walker_.copy())
+      , walker_(*walker_copy_)
+      , partitioning_(other.partitioning_)
+      , max_level_(other.max_level_)
+      , fine_to_coarse_(other.fine_to_coarse_)
+    {
+    }
+
+    void operator()(const tbb::blocked_range<std::size_t>& range) const
+    {
+      for (std::size_t p = range.begin(); p != range.end(); ++p)
+        for (auto&& element : partitioning_.partition(p))
+          walker_.walk_subtree(element, max_level_, fine_to_coarse_);
+    }
+
+    void join(Body& other)
+    {
+      walker_.join(*other.walker_copy_);
+    }
+
+    std::unique_ptr<ThisType> walker_copy_;
+    ThisType& walker_;
+    const PartitioningType& partitioning_;
+    const int max_level_;
+    const bool fine_to_coarse_;
+  }; // struct Body
+#endif // HAVE_TBB
+
+  const GridLayerType grid_layer_;
+  const int max_level_;
+  std::vector<std::unique_ptr<internal::FatherChildObject<GridLayerType>>> functors_;
+  std::vector<EntityType> subtree_;
+}; // class HierarchicWalker
+
+
+} // namespace Grid
+} // namespace XT
+} // namespace Dune
+
+#endif // DUNE_XT_GRID_WALKER_HIERARCHIC_HH
@@ -0,0 +1,296 @@
+// This file is part of the dune-xt-grid project:
+//   https://github.com/dune-community/dune-xt-grid
+// Copyright 2009-2018 dune-xt-grid developers and contributors. All rights reserved.
+// License: Dual licensed as BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+//      or  GPL-2.0+ (http://opensource.org/licenses/gpl-license)
+//          with "runtime exception" (http://www.dune-project.org/license.html)
+
+#ifndef DUNE_XT_GRID_WALKER_INSTRUMENTATION_HH
+#define DUNE_XT_GRID_WALKER_INSTRUMENTATION_HH
+
+#include <chrono>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "wrapper.hh"
+
+namespace Dune {
+namespace XT {
+namespace Grid {
+
+
+/**
+ * \brief Counters and timings of a single functor appended to a Walker, \sa WalkerStatistics.
+ */
+struct WalkerFunctorStatistics
+{
+  std::string name;
+  int codim = 0;
+  //! Number of evaluations of the ApplyOn filter.
+  size_t evaluations = 0;
+  //! Number of evaluations of the ApplyOn filter which returned false.
+  size_t rejections = 0;
+  //! Number of calls of apply_local.
+  size_t calls = 0;
+  //! Time spent in apply_local, summed over all threads.
+  double seconds = 0;
+
+  double rejection_rate() const
+  {
+    return evaluations > 0 ? double(rejections) / double(evaluations) : 0.;
+  }
+
+  void join(const WalkerFunctorStatistics& other)
+  {
+    evaluations += other.evaluations;
+    rejections += other.rejections;
+    calls += other.calls;
+    seconds += other.seconds;
+  }
+}; // struct WalkerFunctorStatistics
+
+
+/**
+ * \brief Counters and timings of the last instrumented walk, \sa Walker::instrument.
+ */
+struct WalkerStatistics
+{
+  //! All codim 0 functors in the order they were appended, followed by all codim 1 functors, \sa Walker::instrument
+  //! for which functors are not contained.
+  std::vector<WalkerFunctorStatistics> functors;
+  //! Wall time of the walk, including prepare and finalize.
+  double seconds = 0;
+  size_t threads = 1;
+
+  //! Time spent in apply_local of all functors, summed over all threads.
+  double functor_seconds() const
+  {
+    double ret = 0;
+    for (const auto& functor : functors)
+      ret += functor.seconds;
+    return ret;
+  }
+
+  //! Time spent outside of apply_local (traversal, filters, prepare, finalize and functors which are not instrumented),
+  //! summed over all threads.
+  double overhead_seconds() const
+  {
+    return seconds * threads - functor_seconds();
+  }
+
+  void report(std::ostream& out) const
+  {
+    out << "walk took " << seconds << "s on " << threads << " thread(s), " << overhead_seconds()
+        << "s (summed over all threads) outside of the functors" << std::endl;
+    for (size_t ii = 0; ii < functors.size(); ++ii) {
+      const auto& functor = functors[ii];
+      out << "  " << ii << ": codim " << functor.codim << " " << functor.name << ": " << functor.calls << " calls, "
+          << functor.seconds << "s, " << functor.rejections << "/" << functor.evaluations << " rejected by filter"
+          << std::endl;
+    }
+  } // ... report(...)
+}; // struct WalkerStatistics
+
+
+namespace internal {
+
+
+/**
+ * \brief Decorates a Codim0Object to record a WalkerFunctorStatistics, inserted by the Walker if instrumented.
+ */
+template <class GridLayerType>
+class Codim0Instrumentation : public Codim0Object<GridLayerType>
+{
+  typedef Codim0Object<GridLayerType> BaseType;
+  typedef Codim0Instrumentation<GridLayerType> ThisType;
+
+public:
+  using typename BaseType::EntityType;
+
+  explicit Codim0Instrumentation(std::unique_ptr<BaseType>&& decorated)
+    : decorated_(std::move(decorated))
+  {
+    statistics_.name = decorated_->name();
+    statistics_.codim = 0;
+  }
+
+  virtual void prepare() override final
+  {
+    decorated_->prepare();
+  }
+
+  virtual bool apply_on(const GridLayerType& grid_layer, const EntityType& entity) const override final
+  {
+    ++statistics_.evaluations;
+    const bool ret = decorated_->apply_on(grid_layer, entity);
+    statistics_.rejections += !ret;
+    return ret;
+  }
+
+  virtual void apply_local(const EntityType& entity) override final
+  {
+    const auto start = std::chrono::steady_clock::now();
+    decorated_->apply_local(entity);
+    statistics_.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ++statistics_.calls;
+  }
+
+  virtual void finalize() override final
+  {
+    decorated_->finalize();
+  }
+
+  virtual ThisType* copy() override final
+  {
+    return new ThisType(std::unique_ptr<BaseType>(decorated_->copy()));
+  }
+
+  virtual Functor::Codim0And1<GridLayerType>* codim0and1_functor() override final
+  {
+    return decorated_->codim0and1_functor();
+  }
+
+  virtual void join(Functor::Codim0<GridLayerType>& other) override final
+  {
+    auto& other_instrumentation = dynamic_cast<ThisType&>(other);
+    statistics_.join(other_instrumentation.statistics_);
+    decorated_->join(*other_instrumentation.decorated_);
+  }
+
+  virtual std::string name() const override final
+  {
+    return decorated_->name();
+  }
+
+  const WalkerFunctorStatistics& statistics() const
+  {
+    return statistics_;
+  }
+
+private:
+  std::unique_ptr<BaseType> decorated_;
+  mutable WalkerFunctorStatistics statistics_;
+}; // class Codim0Instrumentation
+
+
+/**
+ * \brief Decorates a Codim1Object to record a WalkerFunctorStatistics, inserted by the Walker if instrumented.
+ */
+template <class GridLayerType>
+class Codim1Instrumentation : public Codim1Object<GridLayerType>
+{
+  typedef Codim1Object<GridLayerType> BaseType;
+  typedef Codim1Instrumentation<GridLayerType> ThisType;
+
+public:
+  using typename BaseType::EntityType;
+  using typename BaseType::IntersectionType;
+
+  explicit Codim1Instrumentation(std::unique_ptr<BaseType>&& decorated)
+    : decorated_(std::move(decorated))
+  {
+    statistics_.name = decorated_->name();
+    statistics_.codim = 1;
+  }
+
+  virtual void prepare() override final
+  {
+    decorated_->prepare();
+  }
+
+  virtual bool apply_on(const GridLayerType& grid_layer,
+                        const IntersectionType& intersection,
+                        const EntityType& inside_entity) const override final
+  {
+    ++statistics_.evaluations;
+    const bool ret = decorated_->apply_on(grid_layer, intersection, inside_entity);
+    statistics_.rejections += !ret;
+    return ret;
+  }
+
+  virtual bool apply_on_once(const GridLayerType& grid_layer,
+                             const IntersectionType& intersection,
+                             const EntityType& inside_entity) const override final
+  {
+    ++statistics_.evaluations;
+    const bool ret = decorated_->apply_on_once(grid_layer, intersection, inside_entity);
+    statistics_.rejections += !ret;
+    return ret;
+  }
+
+  virtual bool selects_inner_intersections_once() const override final
+  {
+    return decorated_->selects_inner_intersections_once();
+  }
+
+  virtual void apply_local(const IntersectionType& intersection,
+                           const EntityType& inside_entity,
+                           const EntityType& outside_entity) override final
+  {
+    const auto start = std::chrono::steady_clock::now();
+    decorated_->apply_local(intersection, inside_entity, outside_entity);
+    statistics_.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ++statistics_.calls;
+  }
+
+  virtual void apply_local_once(const IntersectionType& intersection,
+                                const EntityType& inside_entity,
+                                const EntityType& outside_entity) override final
+  {
+    const auto start = std::chrono::steady_clock::now();
+    decorated_->apply_local_once(intersection, inside_entity, outside_entity);
+    statistics_.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ++statistics_.calls;
+  }
+
+  virtual void finalize() override final
+  {
+    decorated_->finalize();
+  }
+
+  virtual ThisType* copy() override final
+  {
+    return new ThisType(std::unique_ptr<BaseType>(decorated_->copy()));
+  }
+
+  virtual Functor::Codim0And1<GridLayerType>* codim0and1_functor() override final
+  {
+    return decorated_->codim0and1_functor();
+  }
+
+  virtual ThisType* copy_with(Functor::Codim0And1<GridLayerType>& functor_copy) override final
+  {
+    return new ThisType(std::unique_ptr<BaseType>(decorated_->copy_with(functor_copy)));
+  }
+
+  virtual void join(Functor::Codim1<GridLayerType>& other) override final
+  {
+    auto& other_instrumentation = dynamic_cast<ThisType&>(other);
+    statistics_.join(other_instrumentation.statistics_);
+    decorated_->join(*other_instrumentation.decorated_);
+  }
+
+  virtual std::string name() const override final
+  {
+    return decorated_->name();
+  }
+
+  const WalkerFunctorStatistics& statistics() const
+  {
+    return statistics_;
+  }
+
+private:
+  std::unique_ptr<BaseType> decorated_;
+  mutable WalkerFunctorStatistics statistics_;
+}; // class Codim1Instrumentation
+
+
+} // namespace internal
+} // namespace Grid
+} // namespace XT
+} // namespace Dune
+
+#endif // DUNE_XT_GRID_WALKER_INSTRUMENTATION_HH
@@ -0,0 +1,235 @@
+// This file is part of the dune-xt-grid project:
+//   https://github.com/dune-community/dune-xt-grid
+// Copyright 2009-2018 dune-xt-grid developers and contributors. All rights reserved.
+// License: Dual licensed as BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+//      or  GPL-2.0+ (http://opensource.org/licenses/gpl-license)
+//          with "runtime exception" (http://www.dune-project.org/license.html)
+
+#ifndef DUNE_XT_GRID_WALKER_PLAN_HH
+#define DUNE_XT_GRID_WALKER_PLAN_HH
+
+#include <limits>
+#include <vector>
+
+#include <dune/grid/common/rangegenerators.hh>
+
+#include <dune/xt/grid/entity.hh>
+#include <dune/xt/grid/type_traits.hh>
+#include <dune/xt/grid/walker/fingerprint.hh>
+
+namespace Dune {
+namespace XT {
+namespace Grid {
+
+
+/**
+ * \brief Flat connectivity of a grid layer, to be replayed by a Walker instead of iterating the grid layer.
+ *
+ * Stores the seeds and indices of all elements (in the iteration order of the grid layer) and, in compressed row
+ * storage, for each intersection of each element (in the iteration order of the intersections) the position and index
+ * of the outside element, indexInInside, indexInOutside and whether the intersection is on the boundary, has a
+ * neighbor or is conforming.
+ *
+ * \note The plan is considered valid() as long as the fingerprint of the grid layer did not change, \sa
+ *       internal::GridLayerFingerprint. Unless the grid provides a sequence number (i.e. exact is true), call update()
+ *       or invalidate() after each adaptation of the grid, since elements would otherwise be created from stale seeds.
+ * \sa   Walker::use_walk_plan
+ */
+template <class GridLayerImp>
+class WalkPlan
+{
+  static_assert(is_layer<GridLayerImp>::value, "");
+
+public:
+  typedef GridLayerImp GridLayerType;
+  using EntityType = extract_entity_t<GridLayerType>;
+  using IntersectionType = extract_intersection_t<GridLayerType>;
+  typedef typename EntityType::EntitySeed EntitySeedType;
+  static const constexpr size_t dimDomain = GridLayerType::dimension;
+
+  //! Position of the outside element of intersections without (known) neighbor.
+  static const constexpr size_t no_neighbor = std::numeric_limits<size_t>::max();
+
+  //! Whether each adaptation of the grid is detected by valid(), \sa internal::GridLayerFingerprint.
+  static const constexpr bool exact = internal::GridLayerFingerprint<GridLayerType>::exact;
+
+  explicit WalkPlan(const GridLayerType& grid_layer)
+    : grid_layer_(grid_layer)
+    , valid_(false)
+  {
+    update();
+  }
+
+  const GridLayerType& grid_layer() const
+  {
+    return grid_layer_;
+  }
+
+  bool valid() const
+  {
+    return valid_ && fingerprint_ == internal::GridLayerFingerprint<GridLayerType>(grid_layer_);
+  }
+
+  void invalidate()
+  {
+    valid_ = false;
+  }
+
+  void update()
+  {
+    const auto& index_set = grid_layer_.indexSet();
+    const size_t num_elements = grid_layer_.size(0);
+    element_seeds_.clear();
+    element_seeds_.reserve(num_elements);
+    element_indices_.clear();
+    element_indices_.reserve(num_elements);
+    intersection_offsets_.clear();
+    intersection_offsets_.reserve(num_elements + 1);
+    intersection_offsets_.push_back(0);
+    outsides_.clear();
+    outside_indices_.clear();
+    indices_in_inside_.clear();
+    indices_in_outside_.clear();
+    flags_.clear();
+    std::vector<size_t> position_of_index(index_set.size(0), no_neighbor);
+    for (auto&& element : elements(grid_layer_)) {
+      position_of_index[index_set.index(element)] = element_seeds_.size();
+      element_seeds_.emplace_back(element.seed());
+      element_indices_.push_back(index_set.index(element));
+      // see Walker::walk_range for why we do not use intersections(...) here
+      const auto intersection_it_end = grid_layer_.iend(element);
+      for (auto intersection_it = grid_layer_.ibegin(element); intersection_it != intersection_it_end;
+           ++intersection_it) {
+        const auto& intersection = *intersection_it;
+        unsigned char flags = 0;
+        if (intersection.boundary())
+          flags |= boundary_flag;
+        if (intersection.conforming())
+          flags |= conforming_flag;
+        if (intersection.neighbor()) {
+          flags |= neighbor_flag;
+          // store the index for now, converted to a position below
+          outsides_.push_back(index_set.index(intersection.outside()));
+          outside_indices_.push_back(outsides_.back());
+          indices_in_outside_.push_back(intersection.indexInOutside());
+        } else {
+          outsides_.push_back(no_neighbor);
+          outside_indices_.push_back(element_indices_.back());
+          indices_in_outside_.push_back(-1);
+        }
+        indices_in_inside_.push_back(intersection.indexInInside());
+        flags_.push_back(flags);
+      }
+      intersection_offsets_.push_back(outsides_.size());
+    }
+    for (auto& outside : outsides_)
+      if (outside != no_neighbor)
+        outside = position_of_index[outside];
+    fingerprint_ = internal::GridLayerFingerprint<GridLayerType>(grid_layer_);
+    valid_ = true;
+  } // ... update(...)
+
+  //! Number of elements.
+  size_t size() const
+  {
+    return element_seeds_.size();
+  }
+
+  const EntitySeedType& seed(const size_t ii) const
+  {
+    return element_seeds_[ii];
+  }
+
+  EntityType element(const size_t ii) const
+  {
+    return entity_from_seed(grid_layer_, element_seeds_[ii]);
+  }
+
+  //! Index of the ii-th element w.r.t. the index set of the grid layer.
+  size_t index(const size_t ii) const
+  {
+    return element_indices_[ii];
+  }
+
+  //! First intersection of the ii-th element, intersections are numbered consecutively over all elements.
+  size_t intersections_begin(const size_t ii) const
+  {
+    return intersection_offsets_[ii];
+  }
+
+  size_t intersections_end(const size_t ii) const
+  {
+    return intersection_offsets_[ii + 1];
+  }
+
+  //! Position of the outside element of the jj-th intersection, no_neighbor if there is none.
+  size_t outside(const size_t jj) const
+  {
+    return outsides_[jj];
+  }
+
+  //! Index of the outside element of the jj-th intersection, the index of the inside element if there is no neighbor.
+  size_t outside_index(const size_t jj) const
+  {
+    return outside_indices_[jj];
+  }
+
+  int index_in_inside(const size_t jj) const
+  {
+    return indices_in_inside_[jj];
+  }
+
+  //! -1 if there is no neighbor.
+  int index_in_outside(const size_t jj) const
+  {
+    return indices_in_outside_[jj];
+  }
+
+  bool boundary(const size_t jj) const
+  {
+    return flags_[jj] & boundary_flag;
+  }
+
+  bool neighbor(const size_t jj) const
+  {
+    return flags_[jj] & neighbor_flag;
+  }
+
+  bool conforming(const size_t jj) const
+  {
+    return flags_[jj] & conforming_flag;
+  }
+
+private:
+  static const constexpr unsigned char boundary_flag = 1;
+  static const constexpr unsigned char neighbor_flag = 2;
+  static const constexpr unsigned char conforming_flag = 4;
+
+  const GridLayerType grid_layer_;
+  internal::GridLayerFingerprint<GridLayerType> fingerprint_;
+  bool valid_;
+  std::vector<EntitySeedType> element_seeds_;
+  std::vector<size_t> element_indices_;
+  std::vector<size_t> intersection_offsets_;
+  std::vector<size_t> outsides_;
+  std::vector<size_t> outside_indices_;
+  std::vector<int> indices_in_inside_;
+  std::vector<int> indices_in_outside_;
+  std::vector<unsigned char> flags_;
+}; // class WalkPlan
+
+template <class GL>
+const constexpr size_t WalkPlan<GL>::dimDomain;
+
+template <class GL>
+const constexpr size_t WalkPlan<GL>::no_neighbor;
+
+template <class GL>
+const constexpr bool WalkPlan<GL>::exact;
+
+
+} // namespace Grid
+} // namespace XT
+} // namespace Dune
+
+#endif // DUNE_XT_GRID_WALKER_PLAN_HH
@@ -0,0 +1,536 @@
+// This file is part of the dune-xt-grid project:
+//   https://github.com/dune-community/dune-xt-grid
+// Copyright 2009-2018 dune-xt-grid developers and contributors. All rights reserved.
+// License: Dual licensed as BSD 2-Clause License (http://opensource.org/licenses/BSD-2-Clause)
+//      or  GPL-2.0+ (http://opensource.org/licenses/gpl-license)
+//          with "runtime exception" (http://www.dune-project.org/license.html)
+
+#ifndef DUNE_XT_GRID_WALKER_STATIC_HH
+#define DUNE_XT_GRID_WALKER_STATIC_HH
+
+#include <algorithm>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if HAVE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/tbb_stddef.h>
+#endif
+
+#include <dune/common/unused.hh>
+
+#include <dune/grid/common/rangegenerators.hh>
+
+#include <dune/xt/grid/parallel/partitioning/weighted.hh>
+#include <dune/xt/common/configuration.hh>
+#include <dune/xt/common/parallel/threadmanager.hh>
+#include <dune/xt/grid/type_traits.hh>
+
+#include "apply-on.hh"
+#include "functors.hh"
+
+namespace Dune {
+namespace XT {
+namespace Grid {
+namespace internal {
+
+
+template <class GL, class F>
+struct StaticWalkerFunctorTraits
+{
+  using E = extract_entity_t<GL>;
+  using I = extract_intersection_t<GL>;
+
+  template <class G>
+  static std::true_type is_codim0_lambda_helper(decltype(std::declval<G&>()(std::declval<const E&>()))*);
+  template <class G>
+  static std::false_type is_codim0_lambda_helper(...);
+
+  template <class G>
+  static std::true_type is_codim1_lambda_helper(decltype(
+      std::declval<G&>()(std::declval<const I&>(), std::declval<const E&>(), std::declval<const E&>()))*);
+  template <class G>
+  static std::false_type is_codim1_lambda_helper(...);
+
+  static const constexpr bool is_codim0_and_1 = std::is_base_of<Functor::Codim0And1<GL>, F>::value;
+  static const constexpr bool is_codim0_functor = std::is_base_of<Functor::Codim0<GL>, F>::value || is_codim0_and_1;
+  static const constexpr bool is_codim1_functor = std::is_base_of<Functor::Codim1<GL>, F>::value || is_codim0_and_1;
+  static const constexpr bool is_functor = is_codim0_functor || is_codim1_functor;
+  static const constexpr bool is_codim0 =
+      is_codim0_functor || (!is_functor && decltype(is_codim0_lambda_helper<F>(nullptr))::value);
+  static const constexpr bool is_codim1 =
+      is_codim1_functor || (!is_functor && decltype(is_codim1_lambda_helper<F>(nullptr))::value);
+}; // struct StaticWalkerFunctorTraits
+
+
+/**
+ * \brief Holds a functor (by reference) or a lambda (by value) together with its filters for a StaticWalker.
+ *
+ * Functors derived from Functor::Codim0, Functor::Codim1 or Functor::Codim0And1 are called with qualified names if
+ * their type is final (otherwise the given reference may refer to a derived object, whose overrides have to be called)
+ * and filters are held by value, so no call is dispatched at runtime for final functors.
+ */
+template <class GL, class F, class EntityFilter, class IntersectionFilter>
+class StaticWalkerEntry
+{
+  typedef StaticWalkerEntry<GL, F, EntityFilter, IntersectionFilter> ThisType;
+  typedef StaticWalkerFunctorTraits<GL, F> Traits;
+  typedef typename std::conditional<Traits::is_functor, F&, F>::type StorageType;
+  // 0: lambda, 1: functor (virtual call), 2: final functor (qualified calls are not dispatched at runtime)
+  typedef std::integral_constant<int, Traits::is_functor ? (std::is_final<F>::value ? 2 : 1) : 0> CallType;
+
+public:
+  using EntityType = extract_entity_t<GL>;
+  using IntersectionType = extract_intersection_t<GL>;
+  static const constexpr bool is_codim0 = Traits::is_codim0;
+  static const constexpr bool is_codim1 = Traits::is_codim1;
+
+  static_assert(is_codim0 || is_codim1,
+                "Only Functor::Codim0, Functor::Codim1, Functor::Codim0And1 and lambdas with the signature of their "
+                "apply_local() may be used!");
+
+  template <class FF>
+  StaticWalkerEntry(FF&& functor, const EntityFilter& entity_filter, const IntersectionFilter& intersection_filter)
+    : functor_(std::forward<FF>(functor))
+    , entity_filter_(entity_filter)
+    , intersection_filter_(intersection_filter)
+  {
+  }
+
+  StaticWalkerEntry(ThisType&& source) = default;
+
+  void prepare()
+  {
+    prepare(std::integral_constant<bool, Traits::is_functor>());
+  }
+
+  void apply_local(const GL& grid_layer, const EntityType& entity)
+  {
+    apply_local(grid_layer, entity, std::integral_constant<bool, is_codim0>());
+  }
+
+  void apply_local(const GL& grid_layer,
+                   const IntersectionType& intersection,
+                   const EntityType& inside_entity,
+                   const EntityType& outside_entity)
+  {
+    apply_local(grid_layer, intersection, inside_entity, outside_entity, std::integral_constant<bool, is_codim1>());
+  }
+
+  void finalize()
+  {
+    finalize(std::integral_constant<bool, Traits::is_functor>());
+  }
+
+  //! Thread local copy, \sa Functor::Codim0::copy
+  ThisType copy()
+  {
+    return copy(std::integral_constant<bool, Traits::is_functor>());
+  }
+
+  void join(ThisType& other)
+  {
+    join(other, std::integral_constant<bool, Traits::is_functor>());
+  }
+
+private:
+  template <class FF>
+  StaticWalkerEntry(std::unique_ptr<FF>&& functor_copy, FF& functor, const ThisType& other)
+    : functor_copy_(std::move(functor_copy))
+    , functor_(functor_copy_ ? *functor_copy_ : functor)
+    , entity_filter_(other.entity_filter_)
+    , intersection_filter_(other.intersection_filter_)
+  {
+  }
+
+  void prepare(std::true_type)
+  {
+    functor_.prepare();
+  }
+
+  void prepare(std::false_type)
+  {
+  }
+
+  void finalize(std::true_type)
+  {
+    functor_.finalize();
+  }
+
+  void finalize(std::false_type)
+  {
+  }
+
+  void join(ThisType& other, std::true_type)
+  {
+    if (other.functor_copy_)
+      functor_.join(*other.functor_copy_);
+  }
+
+  void join(ThisType& /*other*/, std::false_type)
+  {
+  }
+
+  void apply_local(const GL& grid_layer, const EntityType& entity, std::true_type)
+  {
+    if (entity_filter_.EntityFilter::apply_on(grid_layer, entity))
+      call(entity, CallType());
+  }
+
+  void apply_local(const GL& /*grid_layer*/, const EntityType& /*entity*/, std::false_type)
+  {
+  }
+
+  void apply_local(const GL& grid_layer,
+                   const IntersectionType& intersection,
+                   const EntityType& inside_entity,
+                   const EntityType& outside_entity,
+                   std::true_type)
+  {
+    if (intersection_filter_.IntersectionFilter::apply_on(grid_layer, intersection))
+      call(intersection, inside_entity, outside_entity, CallType());
+  }
+
+  void apply_local(const GL& /*grid_layer*/,
+                   const IntersectionType& /*intersection*/,
+                   const EntityType& /*inside_entity*/,
+                   const EntityType& /*outside_entity*/,
+                   std::false_type)
+  {
+  }
+
+  void call(const EntityType& entity, std::integral_constant<int, 0>)
+  {
+    functor_(entity);
+  }
+
+  void call(const EntityType& entity, std::integral_constant<int, 1>)
+  {
+    functor_.apply_local(entity);
+  }
+
+  void call(const EntityType& entity, std::integral_constant<int, 2>)
+  {
+    functor_.F::apply_local(entity);
+  }
+
+  void call(const IntersectionType& intersection,
+            const EntityType& inside_entity,
+            const EntityType& outside_entity,
+            std::integral_constant<int, 0>)
+  {
+    functor_(intersection, inside_entity, outside_entity);
+  }
+
+  void call(const IntersectionType& intersection,
+            const EntityType& inside_entity,
+            const EntityType& outside_entity,
+            std::integral_constant<int, 1>)
+  {
+    functor_.apply_local(intersection, inside_entity, outside_entity);
+  }
+
+  void call(const IntersectionType& intersection,
+            const EntityType& inside_entity,
+            const EntityType& outside_entity,
+            std::integral_constant<int, 2>)
+  {
+    functor_.F::apply_local(intersection, inside_entity, outside_entity);
+  }
+
+  ThisType copy(std::true_type)
+  {
+    std::unique_ptr<F> functor_copy;
+    auto* raw_copy = functor_.copy();
+    if (raw_copy) {
+      functor_copy.reset(dynamic_cast<F*>(raw_copy));
+      if (!functor_copy)
+        delete raw_copy; // not a copy of F, share this one
+    }
+    return ThisType(std::move(functor_copy), functor_, *this);
+  }
+
+  ThisType copy(std::false_type)
+  {
+    // lambdas are copied, as in the Walker
+    return ThisType(functor_, entity_filter_, intersection_filter_);
+  }
+
+  std::unique_ptr<F> functor_copy_;
+  StorageType functor_;
+  const EntityFilter entity_filter_;
+  const IntersectionFilter intersection_filter_;
+}; // class StaticWalkerEntry
+
+
+template <class GL, class F>
+struct static_walker_entry
+{
+  typedef StaticWalkerEntry<GL, typename std::decay<F>::type, ApplyOn::AllEntities<GL>, ApplyOn::AllIntersections<GL>>
+      type;
+
+  template <class FF>
+  static type create(FF&& functor)
+  {
+    return type(std::forward<FF>(functor), ApplyOn::AllEntities<GL>(), ApplyOn::AllIntersections<GL>());
+  }
+};
+
+template <class GL, class F, class EF, class IF>
+struct static_walker_entry<GL, StaticWalkerEntry<GL, F, EF, IF>>
+{
+  typedef StaticWalkerEntry<GL, F, EF, IF> type;
+
+  static type create(type&& entry)
+  {
+    return std::move(entry);
+  }
+};
+
+
+} // namespace internal
+
+
+/**
+ * \brief Walker whose functors and filters are known at compile time, \sa make_static_walker.
+ *
+ * Does the same as Walker, but keeps all functors and filters in a tuple, which allows the compiler to inline the
+ * per entity work. In contrast to the Walker, nothing can be appended after construction.
+ */
+template <class GridLayerImp, class... Entries>
+class StaticWalker
+{
+  static_assert(is_layer<GridLayerImp>::value, "");
+  typedef StaticWalker<GridLayerImp, Entries...> ThisType;
+  typedef std::index_sequence_for<Entries...> IndicesType;
+
+public:
+  typedef GridLayerImp GridLayerType;
+  using EntityType = extract_entity_t<GridLayerType>;
+  using IntersectionType = extract_intersection_t<GridLayerType>;
+  static const constexpr bool has_codim1 = std::max({false, Entries::is_codim1...});
+
+  StaticWalker(GridLayerType grd_lr, Entries&&... entries)
+    : grid_layer_(grd_lr)
+    , entries_(std::move(entries)...)
+  {
+  }
+
+  StaticWalker(ThisType&& source) = default;
+
+  const GridLayerType& grid_layer() const
+  {
+    return grid_layer_;
+  }
+
+  void prepare()
+  {
+    prepare(IndicesType());
+  }
+
+  void apply_local(const EntityType& entity)
+  {
+    apply_local(entity, IndicesType());
+  }
+
+  void
+  apply_local(const IntersectionType& intersection, const EntityType& inside_entity, const EntityType& outside_entity)
+  {
+    apply_local(intersection, inside_entity, outside_entity, IndicesType());
+  }
+
+  void finalize()
+  {
+    finalize(IndicesType());
+  }
+
+  void walk(const bool use_tbb = false)
+  {
+    prepare();
+#if HAVE_TBB
+    if (use_tbb) {
+      // many small chunks, which are distributed among the threads by work stealing
+      const auto num_partitions =
+          DXTC_CONFIG_GET("threading.partition_factor", 8u) * XT::Common::threadManager().current_threads();
+      WeightedPartitioning<GridLayerType> partitioning(grid_layer_, num_partitions);
+      tbb::blocked_range<std::size_t> range(0, partitioning.partitions());
+      Body<WeightedPartitioning<GridLayerType>> body(*this, partitioning);
+      tbb::parallel_reduce(range, body);
+    } else
+      walk_range(elements(grid_layer_));
+#else
+    DUNE_UNUSED_PARAMETER(use_tbb);
+    walk_range(elements(grid_layer_));
+#endif
+    finalize();
+  } // ... walk(...)
+
+  template <class EntityRange>
+  void walk_range(const EntityRange& entity_range)
+  {
+    for (const EntityType& entity : entity_range) {
+      apply_local(entity);
+      walk_intersections(entity, std::integral_constant<bool, has_codim1>());
+    }
+  } // ... walk_range(...)
+
+private:
+  StaticWalker(GridLayerType grd_lr, std::tuple<Entries...>&& entries)
+    : grid_layer_(grd_lr)
+    , entries_(std::move(entries))
+  {
+  }
+
+  template <std::size_t... ii>
+  void prepare(std::index_sequence<ii...>)
+  {
+    int dummy[] = {0, (std::get<ii>(entries_).prepare(), 0)...};
+    DUNE_UNUSED_PARAMETER(dummy);
+  }
+
+  template <std::size_t... ii>
+  void apply_local(const EntityType& entity, std::index_sequence<ii...>)
+  {
+    int dummy[] = {0, (std::get<ii>(entries_).apply_local(grid_layer_, entity), 0)...};
+    DUNE_UNUSED_PARAMETER(dummy);
+  }
+
+  template <std::size_t... ii>
+  void apply_local(const IntersectionType& intersection,
+                   const EntityType& inside_entity,
+                   const EntityType& outside_entity,
+                   std::index_sequence<ii...>)
+  {
+    int dummy[] = {
+        0, (std::get<ii>(entries_).apply_local(grid_layer_, intersection, inside_entity, outside_entity), 0)...};
+    DUNE_UNUSED_PARAMETER(dummy);
+  }
+
+  template <std::size_t... ii>
+  void finalize(std::index_sequence<ii...>)
+  {
+    int dummy[] = {0, (std::get<ii>(entries_).finalize(), 0)...};
+    DUNE_UNUSED_PARAMETER(dummy);
+  }
+
+  template <std::size_t... ii>
+  std::unique_ptr<ThisType> copy(std::index_sequence<ii...>)
+  {
+    return std::unique_ptr<ThisType>(
+        new ThisType(grid_layer_, std::tuple<Entries...>(std::get<ii>(entries_).copy()...)));
+  }
+
+  template <std::size_t... ii>
+  void join(ThisType& other, std::index_sequence<ii...>)
+  {
+    int dummy[] = {0, (std::get<ii>(entries_).join(std::get<ii>(other.entries_)), 0)...};
+    DUNE_UNUSED_PARAMETER(dummy);
+  }
+
+  void walk_intersections(const EntityType& entity, std::true_type)
+  {
+    // see Walker::walk_range for why we do not use intersections(...) here
+    const auto intersection_it_end = grid_layer_.iend(entity);
+    for (auto intersection_it = grid_layer_.ibegin(entity); intersection_it != intersection_it_end;
+         ++intersection_it) {
+      const auto& intersection = *intersection_it;
+      if (intersection.neighbor()) {
+        const auto neighbor = intersection.outside();
+        apply_local(intersection, entity, neighbor);
+      } else
+        apply_local(intersection, entity, entity);
+    }
+  } // ... walk_intersections(...)
+
+  void walk_intersections(const EntityType& /*entity*/, std::false_type)
+  {
+  }
+
+#if HAVE_TBB
+  //! \sa Walker::Body
+  template <class PartioningType>
+  struct Body
+  {
+    Body(ThisType& walker, const PartioningType& partitioning)
+      : walker_(walker)
+      , partitioning_(partitioning)
+    {
+    }
+
+    Body(Body& other, tbb::split /*split*/)
+      : walker_copy_(other.walker_.copy(IndicesType()))
+      , walker_(*walker_copy_)
+      , partitioning_(other.partitioning_)
+    {
+    }
+
+    void operator()(const tbb::blocked_range<std::size_t>& range) const
+    {
+      for (std::size_t p = range.begin(); p != range.end(); ++p)
+        walker_.walk_range(partitioning_.partition(p));
+    }
+
+    void join(Body& other)
+    {
+      walker_.join(*other.walker_copy_, IndicesType());
+    }
+
+    std::unique_ptr<ThisType> walker_copy_;
+    ThisType& walker_;
+    const PartioningType& partitioning_;
+  }; // struct Body
+#endif // HAVE_TBB
+
+  GridLayerType grid_layer_;
+  std::tuple<Entries...> entries_;
+}; // class StaticWalker
+
+
+/**
+ * \brief Attaches filters to a functor or lambda for make_static_walker, \sa ApplyOn.
+ *
+ * \note The filters are copied and should be given by their actual type (e.g. ApplyOn::BoundaryIntersections) to
+ *       allow for inlining.
+ */
+template <class GL,
+          class F,
+          class EntityFilter = ApplyOn::AllEntities<GL>,
+          class IntersectionFilter = ApplyOn::AllIntersections<GL>>
+internal::StaticWalkerEntry<GL, typename std::decay<F>::type, EntityFilter, IntersectionFilter>
+static_apply_on(F&& functor,
+                const EntityFilter& entity_filter = EntityFilter(),
+                const IntersectionFilter& intersection_filter = IntersectionFilter())
+{
+  return internal::StaticWalkerEntry<GL, typename std::decay<F>::type, EntityFilter, IntersectionFilter>(
+      std::forward<F>(functor), entity_filter, intersection_filter);
+}
+
+
+/**
+ * \brief Creates a StaticWalker for the given functors, lambdas and results of static_apply_on.
+ *
+ * Functors (derived from Functor::Codim0, Functor::Codim1 or Functor::Codim0And1) are held by reference, lambdas are
+ * copied. Usage:
+\code
+auto walker = make_static_walker(grid_layer, functor, [&](const auto& element) { ... });
+walker.walk();
+\endcode
+ */
+template <class GL, class... Fs>
+StaticWalker<GL, typename internal::static_walker_entry<GL, typename std::decay<Fs>::type>::type...>
+make_static_walker(const GL& grid_layer, Fs&&... functors)
+{
+  return StaticWalker<GL, typename internal::static_walker_entry<GL, typename std::decay<Fs>::type>::type...>(
+      grid_layer,
+      internal::static_walker_entry<GL, typename std::decay<Fs>::type>::create(std::forward<Fs>(functors))...);
+}
+
+
+} // namespace Grid
+} // namespace XT
+} // namespace Dune
+
+#endif // DUNE_XT_GRID_WALKER_STATIC_HH
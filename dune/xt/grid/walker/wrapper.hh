@@ -12,6 +12,14 @@
 #ifndef DUNE_XT_GRID_WALKER_WRAPPER_HH
 #define DUNE_XT_GRID_WALKER_WRAPPER_HH
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <dune/common/classname.hh>
+
 #include "apply-on.hh"
 #include "functors.hh"
 
@@ -20,6 +28,148 @@ namespace XT {
 namespace Grid {
 namespace internal {
 
+
+/**
+ * \brief Owns the filter of a wrapper, skips ApplyOn::AllEntities and calls ApplyOn::EntityMask without virtual
+ *        dispatch.
+ *
+ * The shared singleton ApplyOn::all_entities() is not owned (and not deleted).
+ */
+template <class GridLayerType>
+class EntityFilter
+{
+public:
+  typedef ApplyOn::WhichEntity<GridLayerType> WhichEntityType;
+  typedef typename WhichEntityType::EntityType EntityType;
+
+  explicit EntityFilter(const WhichEntityType* where)
+    : where_(where == ApplyOn::all_entities<GridLayerType>()
+                 ? std::shared_ptr<const WhichEntityType>(std::shared_ptr<const WhichEntityType>(), where)
+                 : std::shared_ptr<const WhichEntityType>(where))
+    , all_(dynamic_cast<const ApplyOn::AllEntities<GridLayerType>*>(where) != nullptr)
+    , mask_(dynamic_cast<const ApplyOn::EntityMask<GridLayerType>*>(where))
+  {
+  }
+
+  bool apply_on(const GridLayerType& grid_layer, const EntityType& entity) const
+  {
+    if (all_)
+      return true;
+    if (mask_)
+      return mask_->apply_on(grid_layer, entity);
+    return where_->apply_on(grid_layer, entity);
+  }
+
+  //! Whether this filter selects all entities, \sa Codim0Object::selects_all
+  bool selects_all() const
+  {
+    return all_;
+  }
+
+private:
+  std::shared_ptr<const WhichEntityType> where_;
+  bool all_;
+  const ApplyOn::EntityMask<GridLayerType>* mask_;
+}; // class EntityFilter
+
+
+/**
+ * \brief Owns the filter of a wrapper, skips ApplyOn::AllIntersections and calls ApplyOn::IntersectionMask without
+ *        virtual dispatch.
+ *
+ * The shared singleton ApplyOn::all_intersections() is not owned (and not deleted).
+ */
+template <class GridLayerType>
+class IntersectionFilter
+{
+public:
+  typedef ApplyOn::WhichIntersection<GridLayerType> WhichIntersectionType;
+  typedef typename WhichIntersectionType::IntersectionType IntersectionType;
+  using EntityType = extract_entity_t<GridLayerType>;
+
+  explicit IntersectionFilter(const WhichIntersectionType* where)
+    : where_(where == ApplyOn::all_intersections<GridLayerType>()
+                 ? std::shared_ptr<const WhichIntersectionType>(std::shared_ptr<const WhichIntersectionType>(), where)
+                 : std::shared_ptr<const WhichIntersectionType>(where))
+    , all_(dynamic_cast<const ApplyOn::AllIntersections<GridLayerType>*>(where) != nullptr)
+    , mask_(dynamic_cast<const ApplyOn::IntersectionMask<GridLayerType>*>(where))
+    , selects_inner_intersections_once_(where_->selects_inner_intersections_once())
+  {
+  }
+
+  bool apply_on(const GridLayerType& grid_layer, const IntersectionType& intersection) const
+  {
+    if (all_)
+      return true;
+    if (mask_)
+      return mask_->apply_on(grid_layer, intersection);
+    return where_->apply_on(grid_layer, intersection);
+  }
+
+  //! Like apply_on(grid_layer, intersection), but ApplyOn::IntersectionMask does not need to create the inside element.
+  bool apply_on(const GridLayerType& grid_layer, const IntersectionType& intersection, const size_t inside_index) const
+  {
+    if (all_)
+      return true;
+    if (mask_)
+      return mask_->apply_on(grid_layer, intersection, inside_index);
+    return where_->apply_on(grid_layer, intersection);
+  }
+
+  //! \sa apply_on(grid_layer, intersection, inside_index)
+  bool apply_on(const GridLayerType& grid_layer,
+                const IntersectionType& intersection,
+                const EntityType& inside_entity) const
+  {
+    if (all_)
+      return true;
+    if (mask_)
+      return mask_->apply_on(grid_layer, intersection, size_t(grid_layer.indexSet().index(inside_entity)));
+    return where_->apply_on(grid_layer, intersection);
+  }
+
+  //! \sa Codim1Object::apply_on_once
+  bool apply_on_once(const GridLayerType& grid_layer, const IntersectionType& intersection) const
+  {
+    return selects_inner_intersections_once_ || apply_on(grid_layer, intersection);
+  }
+
+  //! \sa Codim1Object::apply_on_once
+  bool apply_on_once(const GridLayerType& grid_layer,
+                     const IntersectionType& intersection,
+                     const size_t inside_index) const
+  {
+    return selects_inner_intersections_once_ || apply_on(grid_layer, intersection, inside_index);
+  }
+
+  //! \sa Codim1Object::apply_on_once
+  bool apply_on_once(const GridLayerType& grid_layer,
+                     const IntersectionType& intersection,
+                     const EntityType& inside_entity) const
+  {
+    return selects_inner_intersections_once_ || apply_on(grid_layer, intersection, inside_entity);
+  }
+
+  //! Whether this filter selects all intersections, \sa Codim1Object::selects_all
+  bool selects_all() const
+  {
+    return all_;
+  }
+
+  //! \sa ApplyOn::WhichIntersection::selects_inner_intersections_once
+  bool selects_inner_intersections_once() const
+  {
+    return selects_inner_intersections_once_;
+  }
+
+private:
+  std::shared_ptr<const WhichIntersectionType> where_;
+  bool all_;
+  const ApplyOn::IntersectionMask<GridLayerType>* mask_;
+  bool selects_inner_intersections_once_;
+}; // class IntersectionFilter
+
+
 template <class GridLayerType>
 class Codim0Object : public Functor::Codim0<GridLayerType>
 {
@@ -33,6 +183,37 @@ public:
   }
 
   virtual bool apply_on(const GridLayerType& grid_layer, const EntityType& entity) const = 0;
+
+  /**
+   * \brief Whether apply_on() is true for all entities, so that the Walker may skip calling it.
+   *
+   * Determined once when the wrapper is created, \sa EntityFilter::selects_all.
+   */
+  bool selects_all() const
+  {
+    return selects_all_;
+  }
+
+  virtual Codim0Object<GridLayerType>* copy() override = 0;
+
+  /**
+   * \brief The Functor::Codim0And1 applied by this object, if any, nullptr else.
+   *
+   * Used by Walker::copy to hand the copy of such a functor to its codim 1 part, \sa Codim1Object::copy_with.
+   */
+  virtual Functor::Codim0And1<GridLayerType>* codim0and1_functor()
+  {
+    return nullptr;
+  }
+
+  //! Used to identify the functor, \sa WalkerStatistics
+  virtual std::string name() const
+  {
+    return Dune::className(*this);
+  }
+
+protected:
+  bool selects_all_ = false;
 };
 
 template <class GridLayerImp, class ReturnType>
@@ -49,10 +230,25 @@ public:
   virtual bool apply_on(const GridLayerType& grid_layer, const EntityType& entity) const = 0;
 };
 
+//! \sa Codim0Object::codim0and1_functor
+template <class GridLayerType>
+Functor::Codim0And1<GridLayerType>* as_codim0and1(Functor::Codim0And1<GridLayerType>& functor)
+{
+  return &functor;
+}
+
+//! \sa Codim0Object::codim0and1_functor
+template <class GridLayerType, class FunctorType>
+Functor::Codim0And1<GridLayerType>* as_codim0and1(FunctorType& /*functor*/)
+{
+  return nullptr;
+}
+
 template <class GridLayerType, class Codim0FunctorType>
 class Codim0FunctorWrapper : public Codim0Object<GridLayerType>
 {
   typedef Codim0Object<GridLayerType> BaseType;
+  typedef Codim0FunctorWrapper<GridLayerType, Codim0FunctorType> ThisType;
 
 public:
   typedef typename BaseType::EntityType EntityType;
@@ -61,12 +257,44 @@ public:
     : wrapped_functor_(wrapped_functor)
     , where_(where)
   {
+    this->selects_all_ = where_.selects_all();
   }
 
+private:
+  Codim0FunctorWrapper(std::unique_ptr<Codim0FunctorType>&& functor_copy,
+                       Codim0FunctorType& wrapped_functor,
+                       const EntityFilter<GridLayerType>& where)
+    : functor_copy_(std::move(functor_copy))
+    , wrapped_functor_(wrapped_functor)
+    , where_(where)
+  {
+    this->selects_all_ = where_.selects_all();
+  }
+
+public:
   virtual ~Codim0FunctorWrapper()
   {
   }
 
+  virtual BaseType* copy() override final
+  {
+    std::unique_ptr<Codim0FunctorType> functor_copy(wrapped_functor_.copy());
+    auto& functor = functor_copy ? *functor_copy : wrapped_functor_;
+    return new ThisType(std::move(functor_copy), functor, where_);
+  }
+
+  virtual Functor::Codim0And1<GridLayerType>* codim0and1_functor() override final
+  {
+    return as_codim0and1<GridLayerType>(wrapped_functor_);
+  }
+
+  virtual void join(Functor::Codim0<GridLayerType>& other) override final
+  {
+    auto& other_wrapper = dynamic_cast<ThisType&>(other);
+    if (other_wrapper.functor_copy_)
+      wrapped_functor_.join(*other_wrapper.functor_copy_);
+  }
+
   virtual void prepare() override final
   {
     wrapped_functor_.prepare();
@@ -74,7 +302,7 @@ public:
 
   virtual bool apply_on(const GridLayerType& grid_layer, const EntityType& entity) const override final
   {
-    return where_->apply_on(grid_layer, entity);
+    return where_.apply_on(grid_layer, entity);
   }
 
   virtual void apply_local(const EntityType& entity) override final
@@ -87,30 +315,291 @@ public:
     wrapped_functor_.finalize();
   }
 
+  virtual std::string name() const override final
+  {
+    return Dune::className(wrapped_functor_);
+  }
+
 private:
+  std::unique_ptr<Codim0FunctorType> functor_copy_;
   Codim0FunctorType& wrapped_functor_;
-  std::unique_ptr<const ApplyOn::WhichEntity<GridLayerType>> where_;
+  EntityFilter<GridLayerType> where_;
 }; // class Codim0FunctorWrapper
 
+/**
+ * \brief Applies a Functor::CodimN on all sub-entities of the visited elements, each sub-entity only once.
+ *
+ * The sub-entities already visited are marked in a bitmap indexed by the index set, which is shared by all copies.
+ */
+template <class GridLayerType, size_t codim>
+class CodimNFunctorWrapper : public Codim0Object<GridLayerType>
+{
+  typedef Codim0Object<GridLayerType> BaseType;
+  typedef CodimNFunctorWrapper<GridLayerType, codim> ThisType;
+
+public:
+  typedef Functor::CodimN<GridLayerType, codim> CodimNFunctorType;
+  typedef typename BaseType::EntityType EntityType;
+
+  CodimNFunctorWrapper(const GridLayerType& grid_layer,
+                       CodimNFunctorType& wrapped_functor,
+                       const ApplyOn::WhichEntity<GridLayerType>* where)
+    : grid_layer_(grid_layer)
+    , wrapped_functor_(wrapped_functor)
+    , where_(where)
+  {
+    this->selects_all_ = where_.selects_all();
+  }
+
+private:
+  CodimNFunctorWrapper(std::unique_ptr<CodimNFunctorType>&& functor_copy,
+                       CodimNFunctorType& wrapped_functor,
+                       const ThisType& other)
+    : grid_layer_(other.grid_layer_)
+    , functor_copy_(std::move(functor_copy))
+    , wrapped_functor_(wrapped_functor)
+    , where_(other.where_)
+    , visited_(other.visited_)
+  {
+    this->selects_all_ = where_.selects_all();
+  }
+
+public:
+  virtual BaseType* copy() override final
+  {
+    std::unique_ptr<CodimNFunctorType> functor_copy(wrapped_functor_.copy());
+    auto& functor = functor_copy ? *functor_copy : wrapped_functor_;
+    return new ThisType(std::move(functor_copy), functor, *this);
+  }
+
+  virtual void join(Functor::Codim0<GridLayerType>& other) override final
+  {
+    auto& other_wrapper = dynamic_cast<ThisType&>(other);
+    if (other_wrapper.functor_copy_)
+      wrapped_functor_.join(*other_wrapper.functor_copy_);
+  }
+
+  virtual void prepare() override final
+  {
+    visited_ = std::make_shared<std::vector<std::atomic<bool>>>(grid_layer_.indexSet().size(codim));
+    wrapped_functor_.prepare();
+  }
+
+  virtual bool apply_on(const GridLayerType& grid_layer, const EntityType& entity) const override final
+  {
+    return where_.apply_on(grid_layer, entity);
+  }
+
+  virtual void apply_local(const EntityType& entity) override final
+  {
+    const auto& index_set = grid_layer_.indexSet();
+    const size_t num_sub_entities = entity.subEntities(codim);
+    for (size_t ii = 0; ii < num_sub_entities; ++ii) {
+      if (!(*visited_)[index_set.subIndex(entity, ii, codim)].exchange(true, std::memory_order_relaxed))
+        wrapped_functor_.apply_local(entity.template subEntity<codim>(ii), entity, ii);
+    }
+  }
+
+  virtual void finalize() override final
+  {
+    wrapped_functor_.finalize();
+    visited_ = nullptr;
+  }
+
+  virtual std::string name() const override final
+  {
+    return Dune::className(wrapped_functor_);
+  }
+
+private:
+  const GridLayerType grid_layer_;
+  std::unique_ptr<CodimNFunctorType> functor_copy_;
+  CodimNFunctorType& wrapped_functor_;
+  EntityFilter<GridLayerType> where_;
+  std::shared_ptr<std::vector<std::atomic<bool>>> visited_;
+}; // class CodimNFunctorWrapper
+
+/**
+ * \brief Collects the visited elements in an ElementBatch and applies a Functor::Codim0Batch on each full batch.
+ *
+ * Each thread local copy has its own batch, the remaining elements are handed to the functor when the copy is joined
+ * (or when the walk is finalized).
+ */
+template <class GridLayerType, size_t batch_size>
+class Codim0BatchWrapper : public Codim0Object<GridLayerType>
+{
+  typedef Codim0Object<GridLayerType> BaseType;
+  typedef Codim0BatchWrapper<GridLayerType, batch_size> ThisType;
+
+public:
+  typedef Functor::Codim0Batch<GridLayerType, batch_size> Codim0BatchFunctorType;
+  typedef typename BaseType::EntityType EntityType;
+
+  Codim0BatchWrapper(const GridLayerType& grid_layer,
+                     Codim0BatchFunctorType& wrapped_functor,
+                     const ApplyOn::WhichEntity<GridLayerType>* where)
+    : grid_layer_(grid_layer)
+    , wrapped_functor_(wrapped_functor)
+    , where_(where)
+  {
+    this->selects_all_ = where_.selects_all();
+  }
+
+private:
+  Codim0BatchWrapper(std::unique_ptr<Codim0BatchFunctorType>&& functor_copy,
+                     Codim0BatchFunctorType& wrapped_functor,
+                     const ThisType& other)
+    : grid_layer_(other.grid_layer_)
+    , functor_copy_(std::move(functor_copy))
+    , wrapped_functor_(wrapped_functor)
+    , where_(other.where_)
+  {
+    this->selects_all_ = where_.selects_all();
+  }
+
+public:
+  virtual BaseType* copy() override final
+  {
+    std::unique_ptr<Codim0BatchFunctorType> functor_copy(wrapped_functor_.copy());
+    auto& functor = functor_copy ? *functor_copy : wrapped_functor_;
+    return new ThisType(std::move(functor_copy), functor, *this);
+  }
+
+  virtual void join(Functor::Codim0<GridLayerType>& other) override final
+  {
+    auto& other_wrapper = dynamic_cast<ThisType&>(other);
+    other_wrapper.flush();
+    if (other_wrapper.functor_copy_)
+      wrapped_functor_.join(*other_wrapper.functor_copy_);
+  }
+
+  virtual void prepare() override final
+  {
+    batch_.clear();
+    wrapped_functor_.prepare();
+  }
+
+  virtual bool apply_on(const GridLayerType& grid_layer, const EntityType& entity) const override final
+  {
+    return where_.apply_on(grid_layer, entity);
+  }
+
+  virtual void apply_local(const EntityType& entity) override final
+  {
+    batch_.push_back(entity, grid_layer_.indexSet().index(entity));
+    if (batch_.full())
+      flush();
+  }
+
+  virtual void finalize() override final
+  {
+    flush();
+    wrapped_functor_.finalize();
+  }
+
+  virtual std::string name() const override final
+  {
+    return Dune::className(wrapped_functor_);
+  }
+
+private:
+  void flush()
+  {
+    if (batch_.empty())
+      return;
+    batch_.pad();
+    wrapped_functor_.apply_local(batch_);
+    batch_.clear();
+  }
+
+  const GridLayerType grid_layer_;
+  std::unique_ptr<Codim0BatchFunctorType> functor_copy_;
+  Codim0BatchFunctorType& wrapped_functor_;
+  EntityFilter<GridLayerType> where_;
+  ElementBatch<GridLayerType, batch_size> batch_;
+}; // class Codim0BatchWrapper
+
 template <class GridLayerType>
 class Codim1Object : public Functor::Codim1<GridLayerType>
 {
   typedef Functor::Codim1<GridLayerType> BaseType;
 
 public:
+  typedef typename BaseType::EntityType EntityType;
   typedef typename BaseType::IntersectionType IntersectionType;
 
   virtual ~Codim1Object()
   {
   }
 
-  virtual bool apply_on(const GridLayerType& grid_layer, const IntersectionType& intersection) const = 0;
+  //! The inside element is passed by the Walker, so that it does not need to be created from the intersection.
+  virtual bool apply_on(const GridLayerType& grid_layer,
+                        const IntersectionType& intersection,
+                        const EntityType& inside_entity) const = 0;
+
+  /**
+   * \brief Like apply_on(), for inner intersections which are only visited once,
+   *        \sa Walker::visit_inner_intersections_once
+   */
+  virtual bool apply_on_once(const GridLayerType& grid_layer,
+                             const IntersectionType& intersection,
+                             const EntityType& inside_entity) const
+  {
+    return apply_on(grid_layer, intersection, inside_entity);
+  }
+
+  //! \sa apply_on_once
+  virtual void apply_local_once(const IntersectionType& intersection,
+                                const EntityType& inside_entity,
+                                const EntityType& outside_entity)
+  {
+    this->apply_local(intersection, inside_entity, outside_entity);
+  }
+
+  //! Whether apply_on() and apply_on_once() are true for all intersections, \sa Codim0Object::selects_all
+  bool selects_all() const
+  {
+    return selects_all_;
+  }
+
+  /**
+   * \brief Whether only inner intersections are selected, each from one side, so that nothing is missed if these are
+   *        visited only once, \sa Walker::visit_inner_intersections_once
+   */
+  virtual bool selects_inner_intersections_once() const = 0;
+
+  virtual Codim1Object<GridLayerType>* copy() override = 0;
+
+  //! \sa Codim0Object::codim0and1_functor
+  virtual Functor::Codim0And1<GridLayerType>* codim0and1_functor()
+  {
+    return nullptr;
+  }
+
+  /**
+   * \brief Returns a copy which applies the given copy of codim0and1_functor() (obtained by the codim 0 part of the
+   *        functor) and does not join it, \sa Walker::copy
+   */
+  virtual Codim1Object<GridLayerType>* copy_with(Functor::Codim0And1<GridLayerType>& /*functor_copy*/)
+  {
+    return copy();
+  }
+
+  //! Used to identify the functor, \sa WalkerStatistics
+  virtual std::string name() const
+  {
+    return Dune::className(*this);
+  }
+
+protected:
+  bool selects_all_ = false;
 };
 
 template <class GridLayerType, class Codim1FunctorType>
 class Codim1FunctorWrapper : public Codim1Object<GridLayerType>
 {
   typedef Codim1Object<GridLayerType> BaseType;
+  typedef Codim1FunctorWrapper<GridLayerType, Codim1FunctorType> ThisType;
 
 public:
   typedef typename BaseType::EntityType EntityType;
@@ -120,6 +609,44 @@ public:
     : wrapped_functor_(wrapped_functor)
     , where_(where)
   {
+    this->selects_all_ = where_.selects_all();
+  }
+
+private:
+  Codim1FunctorWrapper(std::unique_ptr<Codim1FunctorType>&& functor_copy,
+                       Codim1FunctorType& wrapped_functor,
+                       const IntersectionFilter<GridLayerType>& where)
+    : functor_copy_(std::move(functor_copy))
+    , wrapped_functor_(wrapped_functor)
+    , where_(where)
+  {
+    this->selects_all_ = where_.selects_all();
+  }
+
+public:
+  virtual BaseType* copy() override final
+  {
+    std::unique_ptr<Codim1FunctorType> functor_copy(wrapped_functor_.copy());
+    auto& functor = functor_copy ? *functor_copy : wrapped_functor_;
+    return new ThisType(std::move(functor_copy), functor, where_);
+  }
+
+  virtual Functor::Codim0And1<GridLayerType>* codim0and1_functor() override final
+  {
+    return as_codim0and1<GridLayerType>(wrapped_functor_);
+  }
+
+  //! Only called if Codim1FunctorType is a Functor::Codim0And1, \sa codim0and1_functor
+  virtual BaseType* copy_with(Functor::Codim0And1<GridLayerType>& functor_copy) override final
+  {
+    return new ThisType(nullptr, dynamic_cast<Codim1FunctorType&>(functor_copy), where_);
+  }
+
+  virtual void join(Functor::Codim1<GridLayerType>& other) override final
+  {
+    auto& other_wrapper = dynamic_cast<ThisType&>(other);
+    if (other_wrapper.functor_copy_)
+      wrapped_functor_.join(*other_wrapper.functor_copy_);
   }
 
   virtual void prepare() override final
@@ -127,9 +654,23 @@ public:
     wrapped_functor_.prepare();
   }
 
-  virtual bool apply_on(const GridLayerType& grid_layer, const IntersectionType& intersection) const override final
+  virtual bool apply_on(const GridLayerType& grid_layer,
+                        const IntersectionType& intersection,
+                        const EntityType& inside_entity) const override final
   {
-    return where_->apply_on(grid_layer, intersection);
+    return where_.apply_on(grid_layer, intersection, inside_entity);
+  }
+
+  virtual bool apply_on_once(const GridLayerType& grid_layer,
+                             const IntersectionType& intersection,
+                             const EntityType& inside_entity) const override final
+  {
+    return where_.apply_on_once(grid_layer, intersection, inside_entity);
+  }
+
+  virtual bool selects_inner_intersections_once() const override final
+  {
+    return where_.selects_inner_intersections_once();
   }
 
   virtual void apply_local(const IntersectionType& intersection,
@@ -144,14 +685,22 @@ public:
     wrapped_functor_.finalize();
   }
 
+  virtual std::string name() const override final
+  {
+    return Dune::className(wrapped_functor_);
+  }
+
 private:
+  std::unique_ptr<Codim1FunctorType> functor_copy_;
   Codim1FunctorType& wrapped_functor_;
-  std::unique_ptr<const ApplyOn::WhichIntersection<GridLayerType>> where_;
+  IntersectionFilter<GridLayerType> where_;
 }; // class Codim1FunctorWrapper
 
 template <class GridLayerType, class WalkerType>
 class WalkerWrapper : public Codim0Object<GridLayerType>, public Codim1Object<GridLayerType>
 {
+  typedef WalkerWrapper<GridLayerType, WalkerType> ThisType;
+
 public:
   typedef typename Codim1Object<GridLayerType>::EntityType EntityType;
   typedef typename Codim1Object<GridLayerType>::IntersectionType IntersectionType;
@@ -159,21 +708,68 @@ public:
   WalkerWrapper(WalkerType& grid_walker, const ApplyOn::WhichEntity<GridLayerType>* which_entities)
     : grid_walker_(grid_walker)
     , which_entities_(which_entities)
-    , which_intersections_(new ApplyOn::AllIntersections<GridLayerType>())
+    , which_intersections_(ApplyOn::all_intersections<GridLayerType>())
   {
   }
 
   WalkerWrapper(WalkerType& grid_walker, const ApplyOn::WhichIntersection<GridLayerType>* which_intersections)
     : grid_walker_(grid_walker)
-    , which_entities_(new ApplyOn::AllEntities<GridLayerType>())
+    , which_entities_(ApplyOn::all_entities<GridLayerType>())
     , which_intersections_(which_intersections)
   {
   }
 
+private:
+  WalkerWrapper(std::unique_ptr<WalkerType>&& walker_copy, const ThisType& source)
+    : walker_copy_(std::move(walker_copy))
+    , grid_walker_(walker_copy_ ? *walker_copy_ : source.grid_walker_)
+    , which_entities_(source.which_entities_)
+    , which_intersections_(source.which_intersections_)
+  {
+  }
+
+  WalkerWrapper(WalkerType& walker_copy, const ThisType& source)
+    : grid_walker_(walker_copy)
+    , which_entities_(source.which_entities_)
+    , which_intersections_(source.which_intersections_)
+  {
+  }
+
+public:
   virtual ~WalkerWrapper()
   {
   }
 
+  virtual ThisType* copy() override final
+  {
+    return new ThisType(std::unique_ptr<WalkerType>(grid_walker_.copy()), *this);
+  }
+
+  //! The codim 1 part uses the copy of the walker made by the codim 0 part, \sa Codim1Object::copy_with
+  virtual Functor::Codim0And1<GridLayerType>* codim0and1_functor() override final
+  {
+    return &grid_walker_;
+  }
+
+  virtual ThisType* copy_with(Functor::Codim0And1<GridLayerType>& walker_copy) override final
+  {
+    return new ThisType(dynamic_cast<WalkerType&>(walker_copy), *this);
+  }
+
+  virtual void join(Functor::Codim0<GridLayerType>& other) override final
+  {
+    auto& other_wrapper = dynamic_cast<ThisType&>(other);
+    if (other_wrapper.walker_copy_)
+      grid_walker_.join(*other_wrapper.walker_copy_);
+  }
+
+  virtual void join(Functor::Codim1<GridLayerType>& other) override final
+  {
+    auto& other_wrapper = dynamic_cast<ThisType&>(other);
+    if (other_wrapper.walker_copy_)
+      grid_walker_.join(*other_wrapper.walker_copy_);
+  }
+
   virtual void prepare() override final
   {
     grid_walker_.prepare();
@@ -181,12 +777,28 @@ public:
 
   virtual bool apply_on(const GridLayerType& grid_layer, const EntityType& entity) const override final
   {
-    return which_entities_->apply_on(grid_layer, entity) && grid_walker_.apply_on(entity);
+    return which_entities_.apply_on(grid_layer, entity) && grid_walker_.apply_on(entity);
+  }
+
+  virtual bool apply_on(const GridLayerType& grid_layer,
+                        const IntersectionType& intersection,
+                        const EntityType& inside_entity) const override final
+  {
+    return which_intersections_.apply_on(grid_layer, intersection, inside_entity)
+           && grid_walker_.apply_on(intersection, inside_entity);
+  }
+
+  virtual bool apply_on_once(const GridLayerType& grid_layer,
+                             const IntersectionType& intersection,
+                             const EntityType& inside_entity) const override final
+  {
+    return which_intersections_.apply_on_once(grid_layer, intersection, inside_entity)
+           && grid_walker_.apply_on_once(intersection, inside_entity);
   }
 
-  virtual bool apply_on(const GridLayerType& grid_layer, const IntersectionType& intersection) const override final
+  virtual bool selects_inner_intersections_once() const override final
   {
-    return which_intersections_->apply_on(grid_layer, intersection) && grid_walker_.apply_on(intersection);
+    return which_intersections_.selects_inner_intersections_once() || grid_walker_.selects_inner_intersections_once();
   }
 
   virtual void apply_local(const EntityType& entity) override final
@@ -201,15 +813,33 @@ public:
     grid_walker_.apply_local(intersection, inside_entity, outside_entity);
   }
 
+  virtual void apply_local_once(const IntersectionType& intersection,
+                                const EntityType& inside_entity,
+                                const EntityType& outside_entity) override final
+  {
+    grid_walker_.apply_local_once(intersection, inside_entity, outside_entity);
+  }
+
   virtual void finalize() override final
   {
     grid_walker_.finalize();
   }
 
+  virtual std::string name() const override final
+  {
+    return Dune::className(grid_walker_);
+  }
+
+  const WalkerType& walker() const
+  {
+    return grid_walker_;
+  }
+
 private:
+  std::unique_ptr<WalkerType> walker_copy_;
   WalkerType& grid_walker_;
-  std::unique_ptr<const ApplyOn::WhichEntity<GridLayerType>> which_entities_;
-  std::unique_ptr<const ApplyOn::WhichIntersection<GridLayerType>> which_intersections_;
+  EntityFilter<GridLayerType> which_entities_;
+  IntersectionFilter<GridLayerType> which_intersections_;
 }; // class WalkerWrapper
 
 template <class GridLayerType>
@@ -222,28 +852,46 @@ public:
   typedef std::function<void(const EntityType&)> LambdaType;
 
   Codim0LambdaWrapper(LambdaType lambda, const ApplyOn::WhichEntity<GridLayerType>* where)
+    : lambda_(std::make_shared<LambdaType>(lambda))
+    , where_(where)
+  {
+    this->selects_all_ = where_.selects_all();
+  }
+
+  Codim0LambdaWrapper(std::shared_ptr<LambdaType> lambda, const EntityFilter<GridLayerType>& where)
     : lambda_(lambda)
     , where_(where)
   {
+    this->selects_all_ = where_.selects_all();
   }
 
   virtual ~Codim0LambdaWrapper()
   {
   }
 
+  virtual BaseType* copy() override final
+  {
+    return new Codim0LambdaWrapper<GridLayerType>(lambda_, where_);
+  }
+
   virtual bool apply_on(const GridLayerType& grid_layer, const EntityType& entity) const override final
   {
-    return where_->apply_on(grid_layer, entity);
+    return where_.apply_on(grid_layer, entity);
   }
 
   virtual void apply_local(const EntityType& entity) override final
   {
-    lambda_(entity);
+    (*lambda_)(entity);
+  }
+
+  virtual std::string name() const override final
+  {
+    return "lambda";
   }
 
 private:
-  LambdaType lambda_;
-  std::unique_ptr<const ApplyOn::WhichEntity<GridLayerType>> where_;
+  std::shared_ptr<LambdaType> lambda_;
+  EntityFilter<GridLayerType> where_;
 }; // class Codim0LambdaWrapper
 
 template <class GridLayerType>
@@ -257,28 +905,256 @@ public:
   typedef std::function<void(const IntersectionType&, const EntityType&, const EntityType&)> LambdaType;
 
   Codim1LambdaWrapper(LambdaType lambda, const ApplyOn::WhichIntersection<GridLayerType>* where)
+    : lambda_(std::make_shared<LambdaType>(lambda))
+    , where_(where)
+  {
+    this->selects_all_ = where_.selects_all();
+  }
+
+  Codim1LambdaWrapper(std::shared_ptr<LambdaType> lambda, const IntersectionFilter<GridLayerType>& where)
     : lambda_(lambda)
     , where_(where)
   {
+    this->selects_all_ = where_.selects_all();
   }
 
-  virtual bool apply_on(const GridLayerType& grid_layer, const IntersectionType& intersection) const override final
+  virtual BaseType* copy() override final
   {
-    return where_->apply_on(grid_layer, intersection);
+    return new Codim1LambdaWrapper<GridLayerType>(lambda_, where_);
+  }
+
+  virtual bool apply_on(const GridLayerType& grid_layer,
+                        const IntersectionType& intersection,
+                        const EntityType& inside_entity) const override final
+  {
+    return where_.apply_on(grid_layer, intersection, inside_entity);
+  }
+
+  virtual bool apply_on_once(const GridLayerType& grid_layer,
+                             const IntersectionType& intersection,
+                             const EntityType& inside_entity) const override final
+  {
+    return where_.apply_on_once(grid_layer, intersection, inside_entity);
+  }
+
+  virtual bool selects_inner_intersections_once() const override final
+  {
+    return where_.selects_inner_intersections_once();
   }
 
   virtual void apply_local(const IntersectionType& intersection,
                            const EntityType& inside_entity,
                            const EntityType& outside_entity) override final
   {
-    lambda_(intersection, inside_entity, outside_entity);
+    (*lambda_)(intersection, inside_entity, outside_entity);
+  }
+
+  virtual std::string name() const override final
+  {
+    return "lambda";
   }
 
 private:
-  LambdaType lambda_;
-  std::unique_ptr<const ApplyOn::WhichIntersection<GridLayerType>> where_;
+  std::shared_ptr<LambdaType> lambda_;
+  IntersectionFilter<GridLayerType> where_;
 }; // class Codim1FunctorWrapper
 
+template <class GridLayerType>
+class FatherChildObject : public Functor::FatherChild<GridLayerType>
+{
+public:
+  virtual ~FatherChildObject()
+  {
+  }
+
+  virtual FatherChildObject<GridLayerType>* copy() override = 0;
+};
+
+template <class GridLayerType>
+class FatherChildFunctorWrapper : public FatherChildObject<GridLayerType>
+{
+  typedef FatherChildObject<GridLayerType> BaseType;
+  typedef FatherChildFunctorWrapper<GridLayerType> ThisType;
+  typedef Functor::FatherChild<GridLayerType> FatherChildFunctorType;
+
+public:
+  typedef typename BaseType::EntityType EntityType;
+
+  explicit FatherChildFunctorWrapper(FatherChildFunctorType& wrapped_functor)
+    : wrapped_functor_(wrapped_functor)
+  {
+  }
+
+private:
+  FatherChildFunctorWrapper(std::unique_ptr<FatherChildFunctorType>&& functor_copy,
+                            FatherChildFunctorType& wrapped_functor)
+    : functor_copy_(std::move(functor_copy))
+    , wrapped_functor_(wrapped_functor)
+  {
+  }
+
+public:
+  virtual BaseType* copy() override final
+  {
+    std::unique_ptr<FatherChildFunctorType> functor_copy(wrapped_functor_.copy());
+    auto& functor = functor_copy ? *functor_copy : wrapped_functor_;
+    return new ThisType(std::move(functor_copy), functor);
+  }
+
+  virtual void join(Functor::FatherChild<GridLayerType>& other) override final
+  {
+    auto& other_wrapper = dynamic_cast<ThisType&>(other);
+    if (other_wrapper.functor_copy_)
+      wrapped_functor_.join(*other_wrapper.functor_copy_);
+  }
+
+  virtual void prepare() override final
+  {
+    wrapped_functor_.prepare();
+  }
+
+  virtual void apply_local(const EntityType& father, const EntityType& child) override final
+  {
+    wrapped_functor_.apply_local(father, child);
+  }
+
+  virtual void finalize() override final
+  {
+    wrapped_functor_.finalize();
+  }
+
+private:
+  std::unique_ptr<FatherChildFunctorType> functor_copy_;
+  FatherChildFunctorType& wrapped_functor_;
+}; // class FatherChildFunctorWrapper
+
+template <class GridLayerType>
+class FatherChildLambdaWrapper : public FatherChildObject<GridLayerType>
+{
+  typedef FatherChildObject<GridLayerType> BaseType;
+
+public:
+  typedef typename BaseType::EntityType EntityType;
+  typedef std::function<void(const EntityType&, const EntityType&)> LambdaType;
+
+  explicit FatherChildLambdaWrapper(LambdaType lambda)
+    : lambda_(std::make_shared<LambdaType>(lambda))
+  {
+  }
+
+  explicit FatherChildLambdaWrapper(std::shared_ptr<LambdaType> lambda)
+    : lambda_(lambda)
+  {
+  }
+
+  virtual BaseType* copy() override final
+  {
+    return new FatherChildLambdaWrapper<GridLayerType>(lambda_);
+  }
+
+  virtual void apply_local(const EntityType& father, const EntityType& child) override final
+  {
+    (*lambda_)(father, child);
+  }
+
+private:
+  std::shared_ptr<LambdaType> lambda_;
+}; // class FatherChildLambdaWrapper
+
+//! \sa Walker::append_indexed
+template <class GridLayerType>
+class IndexedCodim0LambdaWrapper
+{
+public:
+  using EntityType = extract_entity_t<GridLayerType>;
+  typedef std::function<void(const EntityType&, const size_t)> LambdaType;
+
+  IndexedCodim0LambdaWrapper(LambdaType lambda, const ApplyOn::WhichEntity<GridLayerType>* where)
+    : lambda_(std::make_shared<LambdaType>(lambda))
+    , where_(where)
+  {
+  }
+
+  IndexedCodim0LambdaWrapper(std::shared_ptr<LambdaType> lambda, const EntityFilter<GridLayerType>& where)
+    : lambda_(lambda)
+    , where_(where)
+  {
+  }
+
+  IndexedCodim0LambdaWrapper* copy() const
+  {
+    return new IndexedCodim0LambdaWrapper<GridLayerType>(lambda_, where_);
+  }
+
+  bool apply_on(const GridLayerType& grid_layer, const EntityType& entity) const
+  {
+    return where_.apply_on(grid_layer, entity);
+  }
+
+  void apply_local(const EntityType& entity, const size_t index)
+  {
+    (*lambda_)(entity, index);
+  }
+
+private:
+  std::shared_ptr<LambdaType> lambda_;
+  EntityFilter<GridLayerType> where_;
+}; // class IndexedCodim0LambdaWrapper
+
+//! \sa Walker::append_indexed
+template <class GridLayerType>
+class IndexedCodim1LambdaWrapper
+{
+public:
+  using IntersectionType = extract_intersection_t<GridLayerType>;
+  typedef std::function<void(const IntersectionType&, const Functor::IntersectionIndices&)> LambdaType;
+
+  IndexedCodim1LambdaWrapper(LambdaType lambda, const ApplyOn::WhichIntersection<GridLayerType>* where)
+    : lambda_(std::make_shared<LambdaType>(lambda))
+    , where_(where)
+  {
+  }
+
+  IndexedCodim1LambdaWrapper(std::shared_ptr<LambdaType> lambda, const IntersectionFilter<GridLayerType>& where)
+    : lambda_(lambda)
+    , where_(where)
+  {
+  }
+
+  IndexedCodim1LambdaWrapper* copy() const
+  {
+    return new IndexedCodim1LambdaWrapper<GridLayerType>(lambda_, where_);
+  }
+
+  bool apply_on(const GridLayerType& grid_layer, const IntersectionType& intersection, const size_t inside_index) const
+  {
+    return where_.apply_on(grid_layer, intersection, inside_index);
+  }
+
+  //! \sa Codim1Object::apply_on_once
+  bool apply_on_once(const GridLayerType& grid_layer,
+                     const IntersectionType& intersection,
+                     const size_t inside_index) const
+  {
+    return where_.apply_on_once(grid_layer, intersection, inside_index);
+  }
+
+  //! \sa Codim1Object::selects_inner_intersections_once
+  bool selects_inner_intersections_once() const
+  {
+    return where_.selects_inner_intersections_once();
+  }
+
+  void apply_local(const IntersectionType& intersection, const Functor::IntersectionIndices& indices)
+  {
+    (*lambda_)(intersection, indices);
+  }
+
+private:
+  std::shared_ptr<LambdaType> lambda_;
+  IntersectionFilter<GridLayerType> where_;
+}; // class IndexedCodim1LambdaWrapper
+
 } // namespace internal
 } // namespace Grid
 } // namespace XT